@@ -0,0 +1,79 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file AdmissionPolicy.cpp
+* Contains the implementation of the function that decides how a file is
+* analyzed before any of its content is read.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "AdmissionPolicy.h"
+
+namespace EntropyModule
+{
+    Admission admitFile(TskFile *pFile, const ModuleConfig &config)
+    {
+        TSK_OFF_T size = pFile->getSize();
+        uint64_t fileSize = size > 0 ? static_cast<uint64_t>(size) : 0;
+
+        if (fileSize == 0 && config.skipEmpty)
+        {
+            return ADMIT_SKIP;
+        }
+
+        if (fileSize < config.skipBelow || (config.skipAbove > 0 && fileSize > config.skipAbove))
+        {
+            return ADMIT_SKIP;
+        }
+
+        // Files a hash lookup module matched against a known-good hash set, 
+        // such as the NSRL, can be left out. Known-bad files are still 
+        // analyzed.
+        if (config.skipKnown && TskServices::Instance().getImgDB().getKnownStatus(pFile->getId()) == TskImgDB::IMGDB_FILES_KNOWN)
+        {
+            return ADMIT_SKIP;
+        }
+
+        // The statistics and the pyramid describe the whole file, so they 
+        // rule out sampling.
+        bool statistics = config.renyiEntropy || config.chiSquare || config.mean || config.serialCorrelation || config.monteCarloPi || 
+            config.blockSize > 0 || !config.pyramidDir.empty();
+        if (config.sampleAbove > 0 && !statistics && fileSize > config.sampleAbove)
+        {
+            return ADMIT_SAMPLE;
+        }
+
+        return ADMIT_CALCULATE;
+    }
+}
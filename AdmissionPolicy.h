@@ -0,0 +1,88 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file AdmissionPolicy.h
+* Contains the interface of the function that decides how a file is 
+* analyzed before any of its content is read.
+*/
+
+#ifndef _ENTROPY_ADMISSIONPOLICY_H
+#define _ENTROPY_ADMISSIONPOLICY_H
+
+// Module includes
+#include "ModuleConfig.h"
+
+class TskFile;
+
+namespace EntropyModule
+{
+    /**
+    * The ways a file can be admitted for analysis.
+    */
+    enum Admission
+    {
+        /**
+        * The file is not analyzed and nothing is posted for it.
+        */
+        ADMIT_SKIP,
+
+        /**
+        * Every byte of the file is counted.
+        */
+        ADMIT_CALCULATE,
+
+        /**
+        * The entropy of the file is estimated from a sample of it.
+        */
+        ADMIT_SAMPLE
+    };
+
+    /**
+    * Decides how to analyze a file from its size and what the image
+    * database records about it, without reading its content. Files are 
+    * skipped if they are empty and skip_empty is set, if their size is 
+    * outside skip_below and skip_above, or if the database reports them as 
+    * known and skip_known is set. The size checks come first so that 
+    * skipping by size costs no database query. Admitted files larger than 
+    * sample_above are sampled unless a statistic or pyramid that describes 
+    * the whole file was requested.
+    *
+    * Admitted files are still looked up in the result cache before they
+    * are read.
+    *
+    * @param pFile The file.
+    * @param config The module's settings.
+    * @return How to analyze the file.
+    */
+    Admission admitFile(TskFile *pFile, const ModuleConfig &config);
+}
+
+#endif
@@ -0,0 +1,105 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file AlignedBuffer.cpp
+* Contains the implementation of a class that owns a block of memory aligned 
+* for unbuffered I/O.
+*/
+
+// Module includes
+#include "AlignedBuffer.h"
+
+// C/C++ library includes
+#include <new>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+    char *allocateAligned(size_t size)
+    {
+        void *memory = NULL;
+#ifdef _WIN32
+        memory = _aligned_malloc(size, EntropyModule::AlignedBuffer::ALIGNMENT);
+#else
+        if (posix_memalign(&memory, EntropyModule::AlignedBuffer::ALIGNMENT, size) != 0)
+        {
+            memory = NULL;
+        }
+#endif
+        if (memory == NULL)
+        {
+            throw std::bad_alloc();
+        }
+
+        return static_cast<char*>(memory);
+    }
+
+    void freeAligned(char *memory)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        free(memory);
+#endif
+    }
+}
+
+namespace EntropyModule
+{
+    AlignedBuffer::AlignedBuffer(size_t size) :
+        m_data(NULL),
+        m_size(0),
+        m_capacity(0)
+    {
+        resize(size);
+    }
+
+    AlignedBuffer::~AlignedBuffer()
+    {
+        freeAligned(m_data);
+    }
+
+    void AlignedBuffer::resize(size_t size)
+    {
+        if (size > m_capacity)
+        {
+            char *memory = allocateAligned(size);
+            freeAligned(m_data);
+            m_data = memory;
+            m_capacity = size;
+        }
+
+        m_size = size;
+    }
+}
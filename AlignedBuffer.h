@@ -0,0 +1,85 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file AlignedBuffer.h
+* Contains the interface of a class that owns a block of memory aligned for
+* unbuffered I/O.
+*/
+
+#ifndef _ENTROPY_ALIGNEDBUFFER_H
+#define _ENTROPY_ALIGNEDBUFFER_H
+
+// C/C++ library includes
+#include <stddef.h>
+
+namespace EntropyModule
+{
+    /**
+    * Owns a heap buffer whose address is aligned to ALIGNMENT bytes, which
+    * satisfies the sector alignment that direct/unbuffered reads require.
+    * The buffer is not initialized.
+    */
+    class AlignedBuffer
+    {
+    public:
+        enum { ALIGNMENT = 4096 };
+
+        /**
+        * @param size The initial size of the buffer in bytes.
+        * @throws std::bad_alloc if the memory cannot be allocated.
+        */
+        explicit AlignedBuffer(size_t size = 0);
+        ~AlignedBuffer();
+
+        /**
+        * Changes the size of the buffer. The memory is only reallocated when
+        * the buffer grows, and its content is not preserved when it is.
+        *
+        * @param size The new size of the buffer in bytes.
+        * @throws std::bad_alloc if the memory cannot be allocated.
+        */
+        void resize(size_t size);
+
+        char *data() { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        // Not copyable.
+        AlignedBuffer(const AlignedBuffer&);
+        AlignedBuffer &operator=(const AlignedBuffer&);
+
+        char *m_data;
+        size_t m_size;
+        size_t m_capacity;
+    };
+}
+
+#endif
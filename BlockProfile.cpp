@@ -0,0 +1,182 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file BlockProfile.cpp
+* Contains the implementation of a class that summarizes the entropy of the
+* blocks of a file.
+*/
+
+// Module includes
+#include "BlockProfile.h"
+#include "EntropyMath.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+namespace
+{
+    const double MAX_ENTROPY = 8.0;
+}
+
+namespace EntropyModule
+{
+    BlockProfile::BlockProfile(size_t blockSize, size_t stride, double threshold, bool keepSeries)
+    {
+        reset(blockSize, stride, threshold, keepSeries);
+    }
+
+    void BlockProfile::reset(size_t blockSize, size_t stride, double threshold, bool keepSeries)
+    {
+        assert(blockSize > 0 && stride > 0);
+        m_blockSize = blockSize;
+        m_stride = stride;
+        m_threshold = threshold;
+        m_keepSeries = keepSeries;
+        m_window.resize(blockSize);
+        m_windowFill = 0;
+        m_ringPosition = 0;
+        m_untilNextBlock = 0;
+        memset(m_counts, 0, sizeof(m_counts));
+        m_blockCount = 0;
+        m_highEntropyBlockCount = 0;
+        m_minimum = 0.0;
+        m_maximum = 0.0;
+        m_mean = 0.0;
+        m_sumOfSquares = 0.0;
+        m_series.clear();
+    }
+
+    void BlockProfile::add(const uint8_t *data, size_t length)
+    {
+        while (length > 0)
+        {
+            size_t n = 0;
+            if (m_windowFill < m_blockSize)
+            {
+                // Fill the first window.
+                n = std::min(length, m_blockSize - m_windowFill);
+                memcpy(&m_window[m_windowFill], data, n);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    ++m_counts[data[i]];
+                }
+
+                m_windowFill += n;
+                if (m_windowFill == m_blockSize)
+                {
+                    addBlock(m_blockSize);
+                    m_untilNextBlock = m_stride;
+                }
+            }
+            else
+            {
+                // Slide the window: each byte that enters replaces the oldest.
+                n = std::min(std::min(length, m_untilNextBlock), m_blockSize - m_ringPosition);
+                uint8_t *ring = &m_window[m_ringPosition];
+                for (size_t i = 0; i < n; ++i)
+                {
+                    --m_counts[ring[i]];
+                    ++m_counts[data[i]];
+                    ring[i] = data[i];
+                }
+
+                m_ringPosition += n;
+                if (m_ringPosition == m_blockSize)
+                {
+                    m_ringPosition = 0;
+                }
+
+                m_untilNextBlock -= n;
+                if (m_untilNextBlock == 0)
+                {
+                    addBlock(m_blockSize);
+                    m_untilNextBlock = m_stride;
+                }
+            }
+
+            data += n;
+            length -= n;
+        }
+    }
+
+    void BlockProfile::finish()
+    {
+        if (m_blockCount == 0 && m_windowFill > 0)
+        {
+            addBlock(m_windowFill);
+        }
+    }
+
+    double BlockProfile::variance() const
+    {
+        return m_blockCount > 1 ? m_sumOfSquares / static_cast<double>(m_blockCount - 1) : 0.0;
+    }
+
+    void BlockProfile::addBlock(size_t windowSize)
+    {
+        uint64_t counts[256];
+        for (int i = 0; i < 256; ++i)
+        {
+            counts[i] = m_counts[i];
+        }
+
+        double entropy = shannonEntropy(counts, windowSize);
+
+        // Running mean and variance (Welford).
+        ++m_blockCount;
+        if (m_blockCount == 1)
+        {
+            m_minimum = entropy;
+            m_maximum = entropy;
+        }
+        else
+        {
+            m_minimum = std::min(m_minimum, entropy);
+            m_maximum = std::max(m_maximum, entropy);
+        }
+
+        double delta = entropy - m_mean;
+        m_mean += delta / static_cast<double>(m_blockCount);
+        m_sumOfSquares += delta * (entropy - m_mean);
+
+        if (entropy >= m_threshold)
+        {
+            ++m_highEntropyBlockCount;
+        }
+
+        if (m_keepSeries)
+        {
+            m_series.push_back(static_cast<unsigned char>(std::min(entropy, MAX_ENTROPY) * 255.0 / MAX_ENTROPY + 0.5));
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file BlockProfile.h
+* Contains the interface of a class that summarizes the entropy of the 
+* blocks of a file.
+*/
+
+#ifndef _ENTROPY_BLOCKPROFILE_H
+#define _ENTROPY_BLOCKPROFILE_H
+
+// Module includes
+#include "ContentAnalyzer.h"
+
+// C/C++ library includes
+#include <vector>
+
+namespace EntropyModule
+{
+    /**
+    * Computes the entropy of a window of blockSize bytes that slides over the
+    * file stride bytes at a time, and summarizes the entropies of the 
+    * windows. The window's histogram is updated as bytes enter and leave it,
+    * so each byte costs two counter updates however much the windows 
+    * overlap. 
+    *
+    * Windows start at multiples of the stride and must fit in the file. A 
+    * file smaller than one block is treated as a single block.
+    */
+    class BlockProfile : public ContentAnalyzer
+    {
+    public:
+        /**
+        * @param blockSize The size of a window in bytes.
+        * @param stride The distance in bytes between the starts of windows.
+        * @param threshold Windows with at least this entropy are counted as 
+        * high-entropy blocks.
+        * @param keepSeries Whether to keep the quantized entropy of every 
+        * window, which costs a byte per window.
+        */
+        BlockProfile(size_t blockSize, size_t stride, double threshold, bool keepSeries);
+
+        /**
+        * Prepares the profile for a new file, with new settings, keeping 
+        * its memory. Takes the same parameters as the constructor.
+        */
+        void reset(size_t blockSize, size_t stride, double threshold, bool keepSeries);
+
+        virtual void add(const uint8_t *data, size_t length);
+        virtual void finish();
+
+        /**
+        * @return The number of windows.
+        */
+        uint64_t blockCount() const { return m_blockCount; }
+
+        /**
+        * @return The number of windows with at least the threshold entropy.
+        */
+        uint64_t highEntropyBlockCount() const { return m_highEntropyBlockCount; }
+
+        double minimum() const { return m_minimum; }
+        double maximum() const { return m_maximum; }
+        double mean() const { return m_mean; }
+        double variance() const;
+
+        /**
+        * @return The entropy of each window, scaled from 0-8 bits to 0-255.
+        * Empty unless the series was requested.
+        */
+        const std::vector<unsigned char> &series() const { return m_series; }
+
+    private:
+        // Records the entropy of the current window of windowSize bytes.
+        void addBlock(size_t windowSize);
+
+        size_t m_blockSize;
+        size_t m_stride;
+        double m_threshold;
+        bool m_keepSeries;
+
+        // The bytes in the window, used as a ring once the window is full.
+        std::vector<uint8_t> m_window;
+        size_t m_windowFill;
+        size_t m_ringPosition;
+        size_t m_untilNextBlock;
+        uint32_t m_counts[256];
+
+        uint64_t m_blockCount;
+        uint64_t m_highEntropyBlockCount;
+        double m_minimum;
+        double m_maximum;
+        double m_mean;
+        double m_sumOfSquares;
+        std::vector<unsigned char> m_series;
+    };
+}
+
+#endif
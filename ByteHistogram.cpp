@@ -0,0 +1,202 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ByteHistogram.cpp
+* Contains the implementation of a class that accumulates a 256-bin histogram
+* of byte values.
+*/
+
+// Module includes
+#include "ByteHistogram.h"
+
+// C/C++ library includes
+#include <assert.h>
+#include <string.h>
+
+namespace
+{
+    // A bank never holds more counts than the number of bytes added since the
+    // last flush, so flushing at this limit keeps every 32-bit counter safe.
+    const uint64_t FLUSH_LIMIT = 0xFFFFFFFFULL;
+
+    // The number of bytes counted per iteration of the unrolled loop. Deeper
+    // unrolling measured no faster.
+    const int UNROLL = 8;
+
+    /**
+    * Counts the bytes of a block of SIZE bytes, unrolled at compile time so
+    * that byte i goes to bank i % BANKS.
+    */
+    template <typename Counter, size_t BANKS, int SIZE>
+    struct CountBlock
+    {
+        static void count(Counter (&banks)[BANKS][256], const uint8_t *p)
+        {
+            CountBlock<Counter, BANKS, SIZE - 1>::count(banks, p);
+            ++banks[(SIZE - 1) % BANKS][p[SIZE - 1]];
+        }
+    };
+
+    template <typename Counter, size_t BANKS>
+    struct CountBlock<Counter, BANKS, 0>
+    {
+        static void count(Counter (&)[BANKS][256], const uint8_t *)
+        {
+        }
+    };
+
+    /**
+    * Counts bytes into banks of counters of type Counter. The caller makes 
+    * sure no counter can overflow: a counter holds at most 
+    * ceil(length / BANKS) counts, plus at most UNROLL for the first bank.
+    */
+    template <typename Counter, size_t BANKS>
+    void countBytes(Counter (&banks)[BANKS][256], const uint8_t *data, size_t length)
+    {
+        const uint8_t *p = data;
+        const uint8_t *end = data + length;
+        while (end - p >= UNROLL)
+        {
+            CountBlock<Counter, BANKS, UNROLL>::count(banks, p);
+            p += UNROLL;
+        }
+
+        while (p < end)
+        {
+            ++banks[0][*p++];
+        }
+    }
+}
+
+namespace EntropyModule
+{
+    ByteHistogram::ByteHistogram()
+    {
+        clear();
+    }
+
+    void ByteHistogram::clear()
+    {
+        memset(m_banks, 0, sizeof(m_banks));
+        memset(m_counts, 0, sizeof(m_counts));
+        m_total = 0;
+        m_pending = 0;
+    }
+
+    void ByteHistogram::add(const uint8_t *data, size_t length)
+    {
+        while (length > 0)
+        {
+            if (m_pending == FLUSH_LIMIT)
+            {
+                flush();
+            }
+
+            size_t segment = length;
+            if (segment > FLUSH_LIMIT - m_pending)
+            {
+                segment = static_cast<size_t>(FLUSH_LIMIT - m_pending);
+            }
+
+            // Consecutive bytes go to different banks.
+            countBytes(m_banks, data, segment);
+
+            m_pending += segment;
+            m_total += segment;
+            data += segment;
+            length -= segment;
+        }
+    }
+
+    void ByteHistogram::addSmall(const uint8_t *data, size_t length)
+    {
+        assert(length <= SMALL_BUFFER_LIMIT);
+
+        // Each bank gets a quarter of the bytes, plus at most 7 at the end.
+        uint16_t banks[BANK_COUNT][256];
+        memset(banks, 0, sizeof(banks));
+        countBytes(banks, data, length);
+
+        for (int i = 0; i < 256; ++i)
+        {
+            m_counts[i] += static_cast<uint64_t>(banks[0][i]) + banks[1][i] + banks[2][i] + banks[3][i];
+        }
+
+        m_total += length;
+    }
+
+    void ByteHistogram::addRun(uint8_t value, uint64_t count)
+    {
+        m_counts[value] += count;
+        m_total += count;
+    }
+
+    void ByteHistogram::merge(const ByteHistogram &other)
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            uint64_t count = other.m_counts[i];
+            for (int bank = 0; bank < BANK_COUNT; ++bank)
+            {
+                count += other.m_banks[bank][i];
+            }
+
+            m_counts[i] += count;
+        }
+
+        m_total += other.m_total;
+    }
+
+    const uint64_t *ByteHistogram::counts()
+    {
+        flush();
+        return m_counts;
+    }
+
+    void ByteHistogram::flush()
+    {
+        if (m_pending == 0)
+        {
+            return;
+        }
+
+        for (int bank = 0; bank < BANK_COUNT; ++bank)
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                m_counts[i] += m_banks[bank][i];
+            }
+        }
+
+        memset(m_banks, 0, sizeof(m_banks));
+        m_pending = 0;
+    }
+}
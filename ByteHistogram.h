@@ -0,0 +1,129 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ByteHistogram.h
+* Contains the interface of a class that accumulates a 256-bin histogram of
+* byte values.
+*/
+
+#ifndef _ENTROPY_BYTEHISTOGRAM_H
+#define _ENTROPY_BYTEHISTOGRAM_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+
+namespace EntropyModule
+{
+    /**
+    * Accumulates the number of occurrences of each byte value in the data
+    * passed to it.
+    *
+    * Bytes are counted into several interleaved banks of 32-bit counters, so
+    * that runs of equal bytes do not serialize on a single counter (each 
+    * increment would otherwise wait on the store of the previous one). The 
+    * banks are folded into 64-bit totals before any of them can overflow, and 
+    * whenever the totals are requested.
+    */
+    class ByteHistogram
+    {
+    public:
+        /**
+        * The largest buffer addSmall() accepts. No 16-bit bank counter can 
+        * overflow on a buffer of this size.
+        */
+        enum { SMALL_BUFFER_LIMIT = 128 * 1024 };
+
+        ByteHistogram();
+
+        /**
+        * Resets all counts to zero.
+        */
+        void clear();
+
+        /**
+        * Counts the bytes of a buffer.
+        *
+        * @param data The buffer.
+        * @param length The number of bytes in the buffer.
+        */
+        void add(const uint8_t *data, size_t length);
+
+        /**
+        * Counts the bytes of a buffer of at most SMALL_BUFFER_LIMIT bytes, 
+        * such as the whole content of a small file. The counting uses banks
+        * of 16-bit counters on the stack, half the size of the ones add()
+        * uses, and folds them into the totals straight away.
+        *
+        * @param data The buffer.
+        * @param length The number of bytes in the buffer.
+        */
+        void addSmall(const uint8_t *data, size_t length);
+
+        /**
+        * Counts a run of bytes with the same value without examining them, 
+        * such as a hole in a sparse file, which reads as zeros.
+        *
+        * @param value The value of the bytes.
+        * @param count The number of bytes.
+        */
+        void addRun(uint8_t value, uint64_t count);
+
+        /**
+        * Adds the counts of another histogram to this one.
+        *
+        * @param other The histogram to merge.
+        */
+        void merge(const ByteHistogram &other);
+
+        /**
+        * @return The 256 per-byte totals, indexed by byte value.
+        */
+        const uint64_t *counts();
+
+        /**
+        * @return The number of bytes counted.
+        */
+        uint64_t total() const { return m_total; }
+
+    private:
+        enum { BANK_COUNT = 4 };
+
+        void flush();
+
+        uint32_t m_banks[BANK_COUNT][256];
+        uint64_t m_counts[256];
+        uint64_t m_total;
+        uint64_t m_pending;
+    };
+}
+
+#endif
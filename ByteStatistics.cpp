@@ -0,0 +1,176 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ByteStatistics.cpp
+* Contains the implementation of the functions that reduce byte counts to 
+* randomness statistics other than entropy.
+*/
+
+// Module includes
+#include "ByteStatistics.h"
+#include "EntropyMath.h"
+
+// C/C++ library includes
+#include <math.h>
+
+namespace
+{
+    const double Z_MAX = 6.0;
+    const double BIG_X = 20.0;
+    const double LOG_SQRT_PI = 0.5723649429247000870717135;
+    const double I_SQRT_PI = 0.5641895835477562869480795;
+
+    double boundedExp(double x)
+    {
+        return x < -BIG_X ? 0.0 : exp(x);
+    }
+
+    /**
+    * Computes the probability that a standard normal value is below z, with
+    * the polynomial approximation of Adams (ACM algorithm 209).
+    */
+    double normalProbability(double z)
+    {
+        double x = 0.0;
+        if (z != 0.0)
+        {
+            double y = 0.5 * fabs(z);
+            if (y >= Z_MAX * 0.5)
+            {
+                x = 1.0;
+            }
+            else if (y < 1.0)
+            {
+                double w = y * y;
+                x = ((((((((0.000124818987 * w
+                    - 0.001075204047) * w + 0.005198775019) * w
+                    - 0.019198292004) * w + 0.059054035642) * w
+                    - 0.151968751364) * w + 0.319152932694) * w
+                    - 0.531923007300) * w + 0.797884560593) * y * 2.0;
+            }
+            else
+            {
+                y -= 2.0;
+                x = (((((((((((((-0.000045255659 * y
+                    + 0.000152529290) * y - 0.000019538132) * y
+                    - 0.000676904986) * y + 0.001390604284) * y
+                    - 0.000794620820) * y - 0.002034254874) * y
+                    + 0.006549791214) * y - 0.010557625006) * y
+                    + 0.011630447319) * y - 0.009279453341) * y
+                    + 0.005353579108) * y - 0.002141268741) * y
+                    + 0.000535310849) * y + 0.999936657524;
+            }
+        }
+
+        return z > 0.0 ? (x + 1.0) * 0.5 : (1.0 - x) * 0.5;
+    }
+}
+
+namespace EntropyModule
+{
+    double chiSquare(const uint64_t *counts, uint64_t total)
+    {
+        if (total == 0)
+        {
+            return 0.0;
+        }
+
+        double expected = static_cast<double>(total) / 256.0;
+        CompensatedSum sum;
+        for (int i = 0; i < 256; ++i)
+        {
+            double difference = static_cast<double>(counts[i]) - expected;
+            sum.add(difference * difference);
+        }
+
+        return sum.value() / expected;
+    }
+
+    double chiSquareProbability(double statistic, int degreesOfFreedom)
+    {
+        // The series of Hill and Pike (ACM algorithm 299), as used by ent.
+        if (statistic <= 0.0 || degreesOfFreedom < 1)
+        {
+            return 1.0;
+        }
+
+        double a = 0.5 * statistic;
+        bool even = degreesOfFreedom % 2 == 0;
+        double y = degreesOfFreedom > 1 ? boundedExp(-a) : 0.0;
+        double s = even ? y : 2.0 * normalProbability(-sqrt(statistic));
+        if (degreesOfFreedom <= 2)
+        {
+            return s;
+        }
+
+        double x = 0.5 * (degreesOfFreedom - 1.0);
+        double z = even ? 1.0 : 0.5;
+        if (a > BIG_X)
+        {
+            double e = even ? 0.0 : LOG_SQRT_PI;
+            double c = log(a);
+            for (; z <= x; z += 1.0)
+            {
+                e += log(z);
+                s += boundedExp(c * z - a - e);
+            }
+
+            return s;
+        }
+
+        double e = even ? 1.0 : I_SQRT_PI / sqrt(a);
+        double c = 0.0;
+        for (; z <= x; z += 1.0)
+        {
+            e *= a / z;
+            c += e;
+        }
+
+        return c * y + s;
+    }
+
+    double arithmeticMean(const uint64_t *counts, uint64_t total)
+    {
+        if (total == 0)
+        {
+            return 0.0;
+        }
+
+        // The sum is exact in 64 bits for files shorter than 2^56 bytes.
+        uint64_t sum = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            sum += counts[i] * static_cast<uint64_t>(i);
+        }
+
+        return static_cast<double>(sum) / static_cast<double>(total);
+    }
+}
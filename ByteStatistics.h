@@ -0,0 +1,78 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ByteStatistics.h
+* Contains the interface of the functions that reduce byte counts to 
+* randomness statistics other than entropy.
+*/
+
+#ifndef _ENTROPY_BYTESTATISTICS_H
+#define _ENTROPY_BYTESTATISTICS_H
+
+// C/C++ library includes
+#include <stdint.h>
+
+namespace EntropyModule
+{
+    /**
+    * Computes Pearson's chi-square statistic of a 256-bin byte histogram 
+    * against the uniform distribution. Random data scores close to 255, the 
+    * number of degrees of freedom; compressed data usually scores much 
+    * higher.
+    *
+    * @param counts The 256 counts.
+    * @param total The sum of the counts.
+    * @return The statistic, 0 for an empty histogram.
+    */
+    double chiSquare(const uint64_t *counts, uint64_t total);
+
+    /**
+    * Computes the probability that a chi-square distributed value with the
+    * given degrees of freedom exceeds a statistic. 
+    *
+    * @param statistic The chi-square statistic.
+    * @param degreesOfFreedom The degrees of freedom.
+    * @return The probability, between 0 and 1.
+    */
+    double chiSquareProbability(double statistic, int degreesOfFreedom);
+
+    /**
+    * Computes the arithmetic mean of the bytes of a 256-bin byte histogram.
+    * Random data has a mean close to 127.5.
+    *
+    * @param counts The 256 counts.
+    * @param total The sum of the counts.
+    * @return The mean, 0 for an empty histogram.
+    */
+    double arithmeticMean(const uint64_t *counts, uint64_t total);
+}
+
+#endif
@@ -0,0 +1,295 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ChunkScheduler.cpp
+* Contains the implementation of a class that counts the bytes of large files
+* in parallel chunks on a pool of worker threads.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ChunkScheduler.h"
+#include "AlignedBuffer.h"
+#include "ByteHistogram.h"
+#include "PositionalReader.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <memory>
+
+namespace EntropyModule
+{
+    ChunkScheduler::Worker::Worker(ChunkScheduler &scheduler) :
+        m_scheduler(scheduler)
+    {
+    }
+
+    void ChunkScheduler::Worker::run()
+    {
+        m_scheduler.work();
+    }
+
+    ChunkScheduler::ChunkScheduler(size_t threadCount, uint64_t chunkSize, size_t bufferSize) :
+        m_chunkSize(chunkSize),
+        m_bufferSize(bufferSize),
+        m_stopping(false)
+    {
+        m_workers.reserve(threadCount);
+        try
+        {
+            for (size_t i = 0; i < threadCount; ++i)
+            {
+                m_workers.push_back(new Worker(*this));
+                m_workers.back()->thread.start(*m_workers.back());
+            }
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+
+    ChunkScheduler::~ChunkScheduler()
+    {
+        stop();
+    }
+
+    void ChunkScheduler::stop()
+    {
+        {
+            Poco::Mutex::ScopedLock lock(m_mutex);
+            m_stopping = true;
+            m_workAvailable.broadcast();
+        }
+
+        for (size_t i = 0; i < m_workers.size(); ++i)
+        {
+            m_workers[i]->thread.join();
+            delete m_workers[i];
+        }
+
+        m_workers.clear();
+    }
+
+    void ChunkScheduler::count(PositionalReader &reader, uint64_t size, AlignedBuffer &buffer, ByteHistogram &scratch, ByteHistogram &histogram)
+    {
+        Job job;
+        job.reader = &reader;
+        job.size = size;
+        job.chunkCount = (size + m_chunkSize - 1) / m_chunkSize;
+        job.nextChunk = 0;
+        job.completedChunks = 0;
+        job.histogram = &histogram;
+        job.failed = false;
+
+        buffer.resize(m_bufferSize);
+
+        Poco::Mutex::ScopedLock lock(m_mutex);
+        m_jobs.push_back(&job);
+        m_workAvailable.broadcast();
+
+        // Count chunks alongside the workers, then wait for the chunks they 
+        // are still counting.
+        uint64_t chunk = 0;
+        while (claim(job, chunk))
+        {
+            m_mutex.unlock();
+            process(job, chunk, buffer, scratch);
+            m_mutex.lock();
+        }
+
+        // Rather than wait idle, count chunks of other files.
+        while (job.completedChunks < job.nextChunk)
+        {
+            Job *pOther = NULL;
+            if (claimAny(pOther, chunk))
+            {
+                m_mutex.unlock();
+                process(*pOther, chunk, buffer, scratch);
+                m_mutex.lock();
+            }
+            else
+            {
+                m_chunkCompleted.wait(m_mutex);
+            }
+        }
+
+        if (job.failed)
+        {
+            throw TskException(job.error);
+        }
+    }
+
+    size_t ChunkScheduler::help(size_t maxChunks, AlignedBuffer &buffer, ByteHistogram &scratch)
+    {
+        buffer.resize(m_bufferSize);
+
+        size_t counted = 0;
+        Poco::Mutex::ScopedLock lock(m_mutex);
+        Job *pJob = NULL;
+        uint64_t chunk = 0;
+        while (counted < maxChunks && claimAny(pJob, chunk))
+        {
+            m_mutex.unlock();
+            process(*pJob, chunk, buffer, scratch);
+            m_mutex.lock();
+            ++counted;
+        }
+
+        return counted;
+    }
+
+    bool ChunkScheduler::claimAny(Job *&pJob, uint64_t &chunk)
+    {
+        // Jobs leave the queue once all their chunks are claimed, so the 
+        // front job always has one.
+        if (m_stopping || m_jobs.empty())
+        {
+            return false;
+        }
+
+        pJob = m_jobs.front();
+        return claim(*pJob, chunk);
+    }
+
+    bool ChunkScheduler::claim(Job &job, uint64_t &chunk)
+    {
+        if (job.failed || job.nextChunk == job.chunkCount)
+        {
+            return false;
+        }
+
+        chunk = job.nextChunk++;
+        if (job.nextChunk == job.chunkCount)
+        {
+            // Nothing left to hand out, so workers can stop looking at it.
+            std::deque<Job*>::iterator it = std::find(m_jobs.begin(), m_jobs.end(), &job);
+            if (it != m_jobs.end())
+            {
+                m_jobs.erase(it);
+            }
+        }
+
+        return true;
+    }
+
+    void ChunkScheduler::process(Job &job, uint64_t chunk, AlignedBuffer &buffer, ByteHistogram &scratch)
+    {
+        std::string error;
+        try
+        {
+            scratch.clear();
+
+            uint64_t offset = chunk * m_chunkSize;
+            uint64_t end = std::min(offset + m_chunkSize, job.size);
+            while (offset < end)
+            {
+                size_t length = static_cast<size_t>(std::min<uint64_t>(buffer.size(), end - offset));
+                size_t bytesRead = job.reader->readAt(offset, buffer.data(), length);
+                if (bytesRead == 0)
+                {
+                    // The file is shorter than its reported size.
+                    break;
+                }
+
+                scratch.add(reinterpret_cast<const uint8_t*>(buffer.data()), bytesRead);
+                offset += bytesRead;
+            }
+        }
+        catch (TskException &ex)
+        {
+            error = ex.message();
+        }
+        catch (std::exception &ex)
+        {
+            error = ex.what();
+        }
+        catch (...)
+        {
+            error = "unrecognized exception";
+        }
+
+        Poco::Mutex::ScopedLock lock(m_mutex);
+        if (!error.empty() && !job.failed)
+        {
+            job.failed = true;
+            job.error = error;
+            std::deque<Job*>::iterator it = std::find(m_jobs.begin(), m_jobs.end(), &job);
+            if (it != m_jobs.end())
+            {
+                m_jobs.erase(it);
+            }
+        }
+        else if (error.empty())
+        {
+            job.histogram->merge(scratch);
+        }
+
+        ++job.completedChunks;
+        m_chunkCompleted.broadcast();
+    }
+
+    void ChunkScheduler::work()
+    {
+        // A worker that cannot get its buffers simply does not take part.
+        std::auto_ptr<AlignedBuffer> buffer;
+        std::auto_ptr<ByteHistogram> scratch;
+        try
+        {
+            buffer.reset(new AlignedBuffer(m_bufferSize));
+            scratch.reset(new ByteHistogram());
+        }
+        catch (...)
+        {
+            return;
+        }
+
+        Poco::Mutex::ScopedLock lock(m_mutex);
+        while (!m_stopping)
+        {
+            Job *pJob = NULL;
+            uint64_t chunk = 0;
+            if (claimAny(pJob, chunk))
+            {
+                m_mutex.unlock();
+                process(*pJob, chunk, *buffer, *scratch);
+                m_mutex.lock();
+            }
+            else
+            {
+                m_workAvailable.wait(m_mutex);
+            }
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ChunkScheduler.h
+* Contains the interface of a class that counts the bytes of large files in
+* parallel chunks on a pool of worker threads.
+*/
+
+#ifndef _ENTROPY_CHUNKSCHEDULER_H
+#define _ENTROPY_CHUNKSCHEDULER_H
+
+// Poco includes
+#include "Poco/Condition.h"
+#include "Poco/Mutex.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+
+// C/C++ library includes
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace EntropyModule
+{
+    class AlignedBuffer;
+    class ByteHistogram;
+    class PositionalReader;
+
+    /**
+    * Splits files into fixed-size byte ranges (chunks) and counts them on a
+    * pool of worker threads that is shared by all callers. Workers claim the
+    * next unclaimed chunk of the oldest unfinished file, so a file's chunks
+    * are spread over whichever workers are free, and the thread that asked 
+    * for the file counts chunks too. The per-chunk histograms are summed 
+    * into the file's histogram. 
+    *
+    * Chunks can be counted by any thread: a caller waiting for the last 
+    * chunks of its own file counts chunks of other files meanwhile, and 
+    * threads between files can lend a hand through help(). A large file is
+    * thus finished by every thread that has nothing else to do, without 
+    * starting more threads than the pool and the callers.
+    */
+    class ChunkScheduler
+    {
+    public:
+        /**
+        * Starts the worker threads.
+        *
+        * @param threadCount The number of worker threads.
+        * @param chunkSize The size of a chunk in bytes.
+        * @param bufferSize The size of the buffer each thread reads into.
+        */
+        ChunkScheduler(size_t threadCount, uint64_t chunkSize, size_t bufferSize);
+
+        /**
+        * Stops and joins the worker threads. Must not be called while a 
+        * count is in progress.
+        */
+        ~ChunkScheduler();
+
+        /**
+        * Counts the bytes in a range of a file, returning when every chunk 
+        * has been counted.
+        *
+        * @param reader Reads the file's content. Called from several threads.
+        * @param size The number of bytes to count, starting at offset 0.
+        * @param buffer The buffer the calling thread reads into, resized as
+        * needed.
+        * @param scratch A histogram the calling thread counts chunks into 
+        * before they are added to their files' histograms. Its content is 
+        * lost.
+        * @param histogram Receives the counts.
+        * @throws TskException if reading any chunk failed.
+        */
+        void count(PositionalReader &reader, uint64_t size, AlignedBuffer &buffer, ByteHistogram &scratch, ByteHistogram &histogram);
+
+        /**
+        * Counts chunks of files other threads are waiting for, if there are
+        * any.
+        *
+        * @param maxChunks The maximum number of chunks to count.
+        * @param buffer The buffer to read into, resized as needed.
+        * @param scratch A histogram the chunks are counted into before 
+        * being added to their files' histograms. Its content is lost.
+        * @return The number of chunks counted.
+        */
+        size_t help(size_t maxChunks, AlignedBuffer &buffer, ByteHistogram &scratch);
+
+    private:
+        struct Job
+        {
+            PositionalReader *reader;
+            uint64_t size;
+            uint64_t chunkCount;
+            uint64_t nextChunk;
+            uint64_t completedChunks;
+            ByteHistogram *histogram;
+            std::string error;
+            bool failed;
+        };
+
+        class Worker : public Poco::Runnable
+        {
+        public:
+            Worker(ChunkScheduler &scheduler);
+            virtual void run();
+
+            Poco::Thread thread;
+
+        private:
+            ChunkScheduler &m_scheduler;
+        };
+
+        // Not copyable.
+        ChunkScheduler(const ChunkScheduler&);
+        ChunkScheduler &operator=(const ChunkScheduler&);
+
+        // Stops and joins the worker threads.
+        void stop();
+
+        // Claims the next chunk of a job. Called with the mutex held.
+        bool claim(Job &job, uint64_t &chunk);
+
+        // Claims the next chunk of the oldest job with chunks left. Called 
+        // with the mutex held.
+        bool claimAny(Job *&pJob, uint64_t &chunk);
+
+        // Counts a claimed chunk and records its completion.
+        void process(Job &job, uint64_t chunk, AlignedBuffer &buffer, ByteHistogram &scratch);
+
+        // The loop run by each worker thread.
+        void work();
+
+        uint64_t m_chunkSize;
+        size_t m_bufferSize;
+        std::vector<Worker*> m_workers;
+        std::deque<Job*> m_jobs;
+        Poco::Mutex m_mutex;
+        Poco::Condition m_workAvailable;
+        Poco::Condition m_chunkCompleted;
+        bool m_stopping;
+    };
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ContentAnalyzer.h
+* Contains the interface for code that examines file content in order.
+*/
+
+#ifndef _ENTROPY_CONTENTANALYZER_H
+#define _ENTROPY_CONTENTANALYZER_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+
+namespace EntropyModule
+{
+    /**
+    * Interface for code that examines the content of a file in the same pass
+    * that counts its bytes. Content is passed in file order, so analyzers
+    * can depend on the position of bytes, unlike the byte histogram.
+    */
+    class ContentAnalyzer
+    {
+    public:
+        virtual ~ContentAnalyzer() {}
+
+        /**
+        * Examines the next bytes of the file.
+        *
+        * @param data The bytes.
+        * @param length The number of bytes.
+        */
+        virtual void add(const uint8_t *data, size_t length) = 0;
+
+        /**
+        * Called after the last bytes of the file have been added.
+        */
+        virtual void finish() {}
+    };
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ContentSource.h
+* Contains the interface through which other modules hand file content to 
+* the module's streaming entry point, runContent(), and a source for content
+* held in memory. Both are defined here so that those modules need not link
+* with the module.
+*/
+
+#ifndef _ENTROPY_CONTENTSOURCE_H
+#define _ENTROPY_CONTENTSOURCE_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+
+namespace EntropyModule
+{
+    /**
+    * Interface for code that produces the content of a file a part at a 
+    * time, in file order, such as a decompressor or an archive extractor. 
+    * runContent() analyzes the content as run() would analyze the file's 
+    * own content, without the content ever being written to disk.
+    */
+    class ContentSource
+    {
+    public:
+        virtual ~ContentSource() {}
+
+        /**
+        * Produces the next part of the content. The part remains valid until 
+        * the next call.
+        *
+        * @param data Receives the address of the part.
+        * @return The number of bytes in the part, 0 at the end of the 
+        * content.
+        * @throws TskException if the content cannot be produced.
+        */
+        virtual size_t next(const char *&data) = 0;
+    };
+
+    /**
+    * A content source for content that is already in memory, produced as a
+    * single part.
+    */
+    class MemoryContentSource : public ContentSource
+    {
+    public:
+        /**
+        * @param data The content, which must remain valid while the source 
+        * is used.
+        * @param length The number of bytes of content.
+        */
+        MemoryContentSource(const uint8_t *data, size_t length) :
+            m_data(reinterpret_cast<const char*>(data)),
+            m_length(length)
+        {
+        }
+
+        virtual size_t next(const char *&data)
+        {
+            data = m_data;
+            size_t length = m_length;
+            m_length = 0;
+            return length;
+        }
+
+    private:
+        const char *m_data;
+        size_t m_length;
+    };
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropyMath.cpp
+* Contains the implementation of the functions that reduce byte counts to
+* entropy values.
+*/
+
+// Module includes
+#include "EntropyMath.h"
+
+// C/C++ library includes
+#include <math.h>
+
+namespace
+{
+    const double LOG2_E = 1.0 / log(2.0);
+
+    /**
+    * The values of c * log2(c) for small counts, computed when the module is
+    * loaded.
+    */
+    class CountLogTable
+    {
+    public:
+        enum { SIZE = 4096 };
+
+        CountLogTable()
+        {
+            m_values[0] = 0.0;
+            for (int c = 1; c < SIZE; ++c)
+            {
+                double count = static_cast<double>(c);
+                m_values[c] = count * log(count) * LOG2_E;
+            }
+        }
+
+        double operator[](uint64_t count) const { return m_values[count]; }
+
+    private:
+        double m_values[SIZE];
+    };
+
+    const CountLogTable countLogTable;
+}
+
+namespace EntropyModule
+{
+    double countLog2(uint64_t count)
+    {
+        if (count < CountLogTable::SIZE)
+        {
+            return countLogTable[count];
+        }
+
+        double c = static_cast<double>(count);
+        return c * log(c) * LOG2_E;
+    }
+
+    double shannonEntropy(const uint64_t *counts, uint64_t total)
+    {
+        if (total == 0)
+        {
+            return 0.0;
+        }
+
+        CompensatedSum sum;
+        for (int i = 0; i < 256; ++i)
+        {
+            sum.add(countLog2(counts[i]));
+        }
+
+        double n = static_cast<double>(total);
+        double entropy = log(n) * LOG2_E - sum.value() / n;
+
+        // A single-valued histogram can come out a rounding error below 0.
+        return entropy > 0.0 ? entropy : 0.0;
+    }
+
+    void renyiEntropies(const uint64_t *counts, uint64_t total, double &collision, double &minimum)
+    {
+        collision = 0.0;
+        minimum = 0.0;
+        if (total == 0)
+        {
+            return;
+        }
+
+        // The squares of counts over 2^32 do not fit in 64 bits, so they 
+        // are summed as doubles.
+        CompensatedSum squares;
+        uint64_t largest = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            double count = static_cast<double>(counts[i]);
+            squares.add(count * count);
+            largest = counts[i] > largest ? counts[i] : largest;
+        }
+
+        double logN = log(static_cast<double>(total)) * LOG2_E;
+        collision = 2.0 * logN - log(squares.value()) * LOG2_E;
+        minimum = logN - log(static_cast<double>(largest)) * LOG2_E;
+
+        // A single-valued histogram can come out a rounding error below 0.
+        collision = collision > 0.0 ? collision : 0.0;
+        minimum = minimum > 0.0 ? minimum : 0.0;
+    }
+}
@@ -0,0 +1,125 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropyMath.h
+* Contains the interface of the functions that reduce byte counts to entropy
+* values.
+*/
+
+#ifndef _ENTROPY_ENTROPYMATH_H
+#define _ENTROPY_ENTROPYMATH_H
+
+// C/C++ library includes
+#include <math.h>
+#include <stdint.h>
+
+namespace EntropyModule
+{
+    /**
+    * Sums doubles with Neumaier's variant of Kahan summation, which carries
+    * the rounding error of each addition in a second term. The error of the
+    * sum then stays within a couple of ulps however many terms there are 
+    * and however much their magnitudes differ, as when the c * log2(c) 
+    * terms of a file of many gigabytes are summed with those of rare byte
+    * values.
+    */
+    class CompensatedSum
+    {
+    public:
+        CompensatedSum() :
+            m_sum(0.0),
+            m_compensation(0.0)
+        {
+        }
+
+        void add(double value)
+        {
+            double sum = m_sum + value;
+            if (fabs(m_sum) >= fabs(value))
+            {
+                m_compensation += (m_sum - sum) + value;
+            }
+            else
+            {
+                m_compensation += (value - sum) + m_sum;
+            }
+
+            m_sum = sum;
+        }
+
+        double value() const { return m_sum + m_compensation; }
+
+    private:
+        double m_sum;
+        double m_compensation;
+    };
+
+    /**
+    * Computes c * log2(c). Counts below a few thousand are looked up in a 
+    * table, so reducing the histogram of a small file makes no calls to
+    * log().
+    *
+    * @param count The count c.
+    * @return c * log2(c), or 0 for a count of 0.
+    */
+    double countLog2(uint64_t count);
+
+    /**
+    * Computes the Shannon entropy of a 256-bin byte histogram as
+    * H = log2(N) - (1/N) * sum(c * log2(c)), which is the same quantity as
+    * -sum(p * log2(p)) with p = c/N but needs at most one log() per large 
+    * count. The two forms agree to within 1e-9 bits. The terms are summed
+    * with a CompensatedSum, so the result stays accurate for files of any
+    * size.
+    *
+    * @param counts The 256 counts.
+    * @param total The sum of the counts.
+    * @return The entropy in bits per byte, 0 for an empty histogram.
+    */
+    double shannonEntropy(const uint64_t *counts, uint64_t total);
+
+    /**
+    * Computes the Renyi entropies of order 2 and of infinite order of a 
+    * 256-bin byte histogram in one sweep over the bins. The order 2, or 
+    * collision, entropy is H2 = 2 * log2(N) - log2(sum(c * c)) and the min
+    * entropy is Hmin = log2(N) - log2(max(c)). They weigh the most common
+    * byte values more heavily than the Shannon entropy does, which sets 
+    * encrypted data apart from compressed data more clearly.
+    *
+    * @param counts The 256 counts.
+    * @param total The sum of the counts.
+    * @param collision Receives the collision entropy in bits per byte.
+    * @param minimum Receives the min entropy in bits per byte.
+    */
+    void renyiEntropies(const uint64_t *counts, uint64_t total, double &collision, double &minimum);
+}
+
+#endif
@@ -1,444 +1,1797 @@
-/*
-*
-*  The Sleuth Kit
-*
-*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
-*
-*  This is free and unencumbered software released into the public domain.
-*  
-*  Anyone is free to copy, modify, publish, use, compile, sell, or
-*  distribute this software, either in source code form or as a compiled
-*  binary, for any purpose, commercial or non-commercial, and by any
-*  means.
-*  
-*  In jurisdictions that recognize copyright laws, the author or authors
-*  of this software dedicate any and all copyright interest in the
-*  software to the public domain. We make this dedication for the benefit
-*  of the public at large and to the detriment of our heirs and
-*  successors. We intend this dedication to be an overt act of
-*  relinquishment in perpetuity of all present and future rights to this
-*  software under copyright law.
-*  
-*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
-*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
-*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
-*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
-*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
-*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
-*  OTHER DEALINGS IN THE SOFTWARE. 
-*/
-
-/**
-* \file EntropyModule.cpp
-* Contains the implementation of a file analysis module that calculates the
-* entropy of a file's contents.
-*
-* This sample module shows a basic Sleuth Kit Framework module.  It is
-* released as public domain and you are free to remove this header,  use
-* it as a starting point for your module, and choose whatever license that
-* you want.  Note that the framework itself is NOT public domain.
-*/
-
-// TSK Framework includes
-#include "TskModuleDev.h"
-
-// Poco includes
-// Uncomment this include if using the Poco catch blocks.
-//#include "Poco/Exception.h"
-
-// C/C++ library includes
-#include <string>
-#include <sstream>
-#include <math.h>
-#include <assert.h>
-
-// More complex modules will likely put functions and variables other than 
-// the module API functions in separate source files and/or may define various
-// C++ classes to perform the work of the module. However, it is possible to simply 
-// enclose such functions and variables in an anonymous namespace to give them file scope 
-// instead of global scope, as is done in this module. This replaces the older practice 
-// of declaring file scope functions and variables using the "static" keyword. An 
-// anonymous namespace is a more flexible construct, since it is possible to define 
-// types within it.
-//
-// NOTE: Linux/OS-X module developers should make sure module functions
-// other than the module API functions are either uniquely named or bound at module link time. 
-// Placing these functions in an anonymous namespace to give them static-linkage is one way to 
-// accomplish this.
-//
-// CAVEAT: Static data can be incompatible with multithreading, since each
-// thread will get its own copy of the data.
-namespace
-{
-    const char *MODULE_NAME = "Entropy";
-    const char *MODULE_DESCRIPTION = "Performs an entropy calculation for the contents of a given file";
-    const char *MODULE_VERSION = "1.0.0";
-
-    /**
-    * Calculates the entropy of a file.
-    *
-    * @param pFile A TskFile object corrersponding to a file.
-    * @return The entropy of the file.
-    */
-    double calculateEntropy(TskFile *pFile)
-    {
-        const uint32_t FILE_BUFFER_SIZE = 8193;
-
-        uint8_t byte = 0;
-        long byteCounts[256];
-        memset(byteCounts, 0, sizeof(long) * 256);
-        long totalBytes = 0;
-        char buffer[FILE_BUFFER_SIZE];
-        ssize_t bytesRead = 0;
-        do
-        {
-            memset(buffer, 0, FILE_BUFFER_SIZE);
-            bytesRead = pFile->read(buffer, FILE_BUFFER_SIZE);
-            if (bytesRead > 0)
-            {
-                for (int i = 0; i < bytesRead; ++i)
-                {
-                    byte = static_cast<uint8_t>(buffer[i]);
-                    byteCounts[byte]++;
-                }
-
-                totalBytes += bytesRead;
-            }
-        } 
-        while (bytesRead > 0);
-
-        double entropy = 0.0;
-        for (int i = 0; i<256; ++i)
-        {
-            double p = static_cast<double>(byteCounts[i]) / static_cast<double>(totalBytes);
-            if (p > 0.0)
-            {
-                entropy -= p * (log(p) / log(2.0));
-            }
-        }
-
-        return entropy;
-    }
-}
-
-extern "C" 
-{
-    /**
-    * Module identification function. 
-    *
-    * CAVEAT: This function is intended to be called by TSK Framework only. 
-    * Linux/OS-X modules should *not* call this function within the module 
-    * unless appropriate compiler/linker options are used to bind all 
-    * library-internal symbols at link time. 
-    *
-    * @return The name of the module.
-    */
-    TSK_MODULE_EXPORT const char *name()
-    {
-        return MODULE_NAME;
-    }
-
-    /**
-    * Module identification function. 
-    *
-    * CAVEAT: This function is intended to be called by TSK Framework only. 
-    * Linux/OS-X modules should *not* call this function within the module 
-    * unless appropriate compiler/linker options are used to bind all 
-    * library-internal symbols at link time. 
-    *
-    * @return A description of the module.
-    */
-    TSK_MODULE_EXPORT const char *description()
-    {
-        return MODULE_DESCRIPTION;
-    }
-
-    /**
-    * Module identification function. 
-    *
-    * CAVEAT: This function is intended to be called by TSK Framework only. 
-    * Linux/OS-X modules should *not* call this function within the module 
-    * unless appropriate compiler/linker options are used to bind all 
-    * library-internal symbols at link time. 
-    *
-    * @return The version of the module.
-    */
-    TSK_MODULE_EXPORT const char *version()
-    {
-        return MODULE_VERSION;
-    }
-
-    /**
-    * Module initialization function. Receives a string of initialization arguments, 
-    * typically read by the caller from a pipeline configuration file. 
-    * Returns TskModule::OK or TskModule::FAIL. Returning TskModule::FAIL indicates 
-    * the module is not in an operational state.  
-    *
-    * CAVEAT: This function is intended to be called by TSK Framework only. 
-    * Linux/OS-X modules should *not* call this function within the module 
-    * unless appropriate compiler/linker options are used to bind all 
-    * library-internal symbols at link time. 
-    *
-    * @param args a string of initialization arguments.
-    * @return TskModule::OK if initialization succeeded, otherwise TskModule::FAIL.
-    */
-    TskModule::Status TSK_MODULE_EXPORT initialize(const char* arguments)
-    {    
-        // The TSK Framework convention is to prefix error messages with the
-        // name of the module/class and the function that emitted the message. 
-        std::ostringstream msgPrefix;
-        msgPrefix << MODULE_NAME << "::initialize : ";
-
-        // Well-behaved modules should catch and log all possible exceptions
-        // and return an appropriate TskModule::Status to the TSK Framework. 
-        try
-        {
-            // If this module required initialization, the initialization code would
-            // go here.
-
-            return TskModule::OK;
-        }
-        catch (TskException &ex)
-        {
-            std::ostringstream msg;
-            msg << msgPrefix.str() << "TskException: " << ex.message();
-            LOGERROR(msg.str());
-            return TskModule::FAIL;
-        }
-        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
-        //catch (Poco::Exception &ex)
-        //{
-        //    std::ostringstream msg;
-        //    msg << msgPrefix.str() << "Poco::Exception: " << ex.displayText();
-        //    LOGERROR(msg.str());
-        //    return TskModule::FAIL;
-        //}
-        catch (std::exception &ex)
-        {
-            std::ostringstream msg;
-            msg << msgPrefix.str() << "std::exception: " << ex.what();
-            LOGERROR(msg.str());
-            return TskModule::FAIL;
-        }
-        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
-        //catch (System::Exception ^ex)
-        //{
-        //    std::ostringstream msg;
-        //    msg << msgPrefix.str() << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
-        //    LOGERROR(msg.str());
-        //    return TskModule::FAIL;
-        //}        
-        catch (...)
-        {
-            LOGERROR(msgPrefix.str() + "unrecognized exception");
-            return TskModule::FAIL;
-        }
-    }
-
-    /**
-    * Module execution function for file analysis modules. 
-    * Receives a pointer to a file the module is to process. The file is 
-    * represented by a TskFile interface from which both file content and file 
-    * metadata can be retrieved. Returns TskModule::OK, TskModule::FAIL, or 
-    * TskModule::STOP. Returning TskModule::FAIL indicates the module 
-    * experienced an error processing the file. 
-    *
-    * CAVEAT: This function is intended to be called by TSK Framework only. 
-    * Linux/OS-X modules should *not* call this function within the module 
-    * unless appropriate compiler/linker options are used to bind all 
-    * library-internal symbols at link time. 
-    *
-    * @param pFile A pointer to a file to be processed.
-    * @returns TskModule::OK on success, TskModule::FAIL on error, or 
-    * TskModule::STOP. Returning TskModule::STOP is a request to terminate 
-    * processing of the file.     
-    */
-    TskModule::Status TSK_MODULE_EXPORT run(TskFile *pFile)
-    {
-        // The TSK Framework convention is to prefix error messages with the
-        // name of the module/class and the function that emitted the message. 
-        std::ostringstream msgPrefix;
-        msgPrefix << MODULE_NAME << "::run : ";
-
-        // Well-behaved modules should catch and log all possible exceptions
-        // and return an appropriate TskModule::Status to the TSK Framework. 
-        try
-        {
-            assert(pFile != NULL);
-            if (pFile == NULL) 
-            {
-                throw TskException("passed NULL TskFile pointer");
-            }
-
-            // Calculate an entropy value for the file.
-            double entropy = calculateEntropy(pFile);
-
-            // Post the value to the blackboard.
-            pFile->addGenInfoAttribute(TskBlackboardAttribute(TSK_ENTROPY, MODULE_NAME, "", entropy));
-
-            return TskModule::OK;
-        }
-        catch (TskException &ex)
-        {
-            std::ostringstream msg;
-            msg << msgPrefix.str() << "TskException: " << ex.message();
-            LOGERROR(msg.str());
-            return TskModule::FAIL;
-        }
-        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
-        //catch (Poco::Exception &ex)
-        //{
-        //    std::ostringstream msg;
-        //    msg << msgPrefix.str() << "Poco::Exception: " << ex.displayText();
-        //    LOGERROR(msg.str());
-        //    return TskModule::FAIL;
-        //}
-        catch (std::exception &ex)
-        {
-            std::ostringstream msg;
-            msg << msgPrefix.str() << "std::exception: " << ex.what();
-            LOGERROR(msg.str());
-            return TskModule::FAIL;
-        }
-        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
-        //catch (System::Exception ^ex)
-        //{
-        //    std::ostringstream msg;
-        //    msg << msgPrefix.str() << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
-        //    LOGERROR(msg.str());
-        //    return TskModule::FAIL;
-        //}        
-        catch (...)
-        {
-            LOGERROR(msgPrefix.str() + "unrecognized exception");
-            return TskModule::FAIL;
-        }
-    }
-
-    //  /**
-    //   * Module execution function for post-processing modules. 
-    //   *
-    //   * CAVEAT: This function is intended to be called by TSK Framework only. 
-    //   * Linux/OS-X modules should *not* call this function within the module 
-    //   * unless appropriate compiler/linker options are used to bind all 
-    //   * library-internal symbols at link time. 
-    //   *
-    //   * @returns TskModule::OK on success, TskModule::FAIL on error
-    //   */
-    //  TskModule::Status TSK_MODULE_EXPORT report()
-    //  {
-    //      // The TSK Framework convention is to prefix error messages with the
-    //      // name of the module/class and the function that emitted the message. 
-    //      std::ostringstream msgPrefix;
-    //      msgPrefix << MODULE_NAME << "::report : ";
-    //
-    //      // Well-behaved modules should catch and log all possible exceptions
-    //      // and return an appropriate TskModule::Status to the TSK Framework. 
-    //      try
-    //      {
-    //          // If this module could be used in a post-processing pipeline, the 
-    //	      // code would go here.
-    //
-    //		  return TskModule::OK;
-    //      }
-    //      catch (TskException &ex)
-    //      {
-    //          std::ostringstream msg;
-    //          msg << msgPrefix.str() << "TskException: " << ex.message();
-    //          LOGERROR(msg.str());
-    //          return TskModule::FAIL;
-    //      }
-    //      // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
-    //      //catch (Poco::Exception &ex)
-    //      //{
-    //      //    std::ostringstream msg;
-    //      //    msg << msgPrefix.str() << "Poco::Exception: " << ex.displayText();
-    //      //    LOGERROR(msg.str());
-    //      //    return TskModule::FAIL;
-    //      //}
-    //      catch (std::exception &ex)
-    //      {
-    //          std::ostringstream msg;
-    //          msg << msgPrefix.str() << "std::exception: " << ex.what();
-    //          LOGERROR(msg.str());
-    //          return TskModule::FAIL;
-    //      }
-    //      // Uncomment this catch block and add necessary .NET references if using C++/CLI.
-    //      //catch (System::Exception ^ex)
-    //      //{
-    //      //    std::ostringstream msg;
-    //      //    msg << msgPrefix.str() << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
-    //      //    LOGERROR(msg.str());
-    //      //    return TskModule::FAIL;
-    //      //}        
-    //      catch (...)
-    //      {
-    //          LOGERROR(msgPrefix.str() + "unrecognized exception");
-    //          return TskModule::FAIL;
-    //      }
-    //  }
-
-    /**
-    * Module cleanup function. This is where the module should free any resources 
-    * allocated during initialization or execution.
-    *
-    * CAVEAT: This function is intended to be called by TSK Framework only. 
-    * Linux/OS-X modules should *not* call this function within the module 
-    * unless appropriate compiler/linker options are used to bind all 
-    * library-internal symbols at link time. 
-    *
-    * @returns TskModule::OK on success and TskModule::FAIL on error.
-    */
-    TskModule::Status TSK_MODULE_EXPORT finalize()
-    {
-        // The TSK Framework convention is to prefix error messages with the
-        // name of the module/class and the function that emitted the message. 
-        std::ostringstream msgPrefix;
-        msgPrefix << MODULE_NAME << "::finalize : ";
-
-        // Well-behaved modules should catch and log all possible exceptions
-        // and return an appropriate TskModule::Status to the TSK Framework. 
-        try
-        {
-            // If this module required finalization, the finalization code would
-            // go here.
-
-            return TskModule::OK;
-        }
-        catch (TskException &ex)
-        {
-            std::ostringstream msg;
-            msg << msgPrefix.str() << "TskException: " << ex.message();
-            LOGERROR(msg.str());
-            return TskModule::FAIL;
-        }
-        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
-        //catch (Poco::Exception &ex)
-        //{
-        //    std::ostringstream msg;
-        //    msg << msgPrefix.str() << "Poco::Exception: " << ex.displayText();
-        //    LOGERROR(msg.str());
-        //    return TskModule::FAIL;
-        //}
-        catch (std::exception &ex)
-        {
-            std::ostringstream msg;
-            msg << msgPrefix.str() << "std::exception: " << ex.what();
-            LOGERROR(msg.str());
-            return TskModule::FAIL;
-        }
-        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
-        //catch (System::Exception ^ex)
-        //{
-        //    std::ostringstream msg;
-        //    msg << msgPrefix.str() << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
-        //    LOGERROR(msg.str());
-        //    return TskModule::FAIL;
-        //}        
-        catch (...)
-        {
-            LOGERROR(msgPrefix.str() + "unrecognized exception");
-            return TskModule::FAIL;
-        }
-    }
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropyModule.cpp
+* Contains the implementation of a file analysis module that calculates the
+* entropy of a file's contents.
+*
+* This sample module shows a basic Sleuth Kit Framework module.  It is
+* released as public domain and you are free to remove this header,  use
+* it as a starting point for your module, and choose whatever license that
+* you want.  Note that the framework itself is NOT public domain.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "AdmissionPolicy.h"
+#include "AlignedBuffer.h"
+#include "BlockProfile.h"
+#include "ByteHistogram.h"
+#include "ByteStatistics.h"
+#include "ChunkScheduler.h"
+#include "ContentSource.h"
+#include "EntropyMath.h"
+#include "EntropyPyramid.h"
+#include "EntropyResult.h"
+#include "EntropySampler.h"
+#include "GpuCounter.h"
+#include "HistogramEncoding.h"
+#include "LocalFileReader.h"
+#include "MappedFile.h"
+#include "ModuleConfig.h"
+#include "MonteCarloPi.h"
+#include "PositionalReader.h"
+#include "ReadBudget.h"
+#include "ReadPipeline.h"
+#include "ResultAttribute.h"
+#include "ResultCache.h"
+#include "ResumeStore.h"
+#include "RunStatistics.h"
+#include "SerialCorrelation.h"
+#include "ThreadContext.h"
+
+// Poco includes
+#include "Poco/File.h"
+#include "Poco/Path.h"
+// Uncomment this include if using the Poco catch blocks.
+//#include "Poco/Exception.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <assert.h>
+
+// More complex modules will likely put functions and variables other than 
+// the module API functions in separate source files and/or may define various
+// C++ classes to perform the work of the module. However, it is possible to simply 
+// enclose such functions and variables in an anonymous namespace to give them file scope 
+// instead of global scope, as is done in this module. This replaces the older practice 
+// of declaring file scope functions and variables using the "static" keyword. An 
+// anonymous namespace is a more flexible construct, since it is possible to define 
+// types within it.
+//
+// NOTE: Linux/OS-X module developers should make sure module functions
+// other than the module API functions are either uniquely named or bound at module link time. 
+// Placing these functions in an anonymous namespace to give them static-linkage is one way to 
+// accomplish this.
+//
+// CAVEAT: Static data can be incompatible with multithreading, since each
+// thread will get its own copy of the data.
+namespace
+{
+    const char *MODULE_NAME = "Entropy";
+    const char *MODULE_DESCRIPTION = "Performs an entropy calculation for the contents of a given file";
+    const char *MODULE_VERSION = "1.1.0";
+
+    // The settings parsed by initialize(). They are only written by 
+    // initialize() and are read-only while files are being analyzed.
+    EntropyModule::ModuleConfig moduleConfig;
+
+    // The worker threads that count chunks of large files, shared by all 
+    // calls to run(). NULL when parallel counting is disabled.
+    EntropyModule::ChunkScheduler *chunkScheduler = NULL;
+
+    // Counts the bytes of large files on a GPU. NULL when GPU counting is 
+    // disabled or no GPU is available.
+    EntropyModule::GpuCounter *gpuCounter = NULL;
+
+    // The results of files already analyzed, keyed by content hash. NULL 
+    // when the cache is disabled.
+    EntropyModule::ResultCache *resultCache = NULL;
+
+    // Identifies the settings that affect the results held in the cache.
+    std::string resultSignature;
+
+    // The byte counts of files already analyzed, keyed by path, so files 
+    // that have grown since need only their new bytes counted. NULL when 
+    // resuming is disabled.
+    EntropyModule::ResumeStore *resumeStore = NULL;
+
+    // The buffers, histograms and statistics of the threads that call 
+    // run(), created for each thread on its first call. Created by the 
+    // first call to initialize() and released by finalize(), so the 
+    // statistics cover every file analyzed in between.
+    EntropyModule::ThreadContexts *threadContexts = NULL;
+
+    /**
+    * @return The calling thread's context.
+    */
+    EntropyModule::ThreadContext &currentContext()
+    {
+        if (threadContexts == NULL)
+        {
+            throw TskException("module is not initialized");
+        }
+
+        return threadContexts->current();
+    }
+
+    /**
+    * Builds the prefix of the error messages logged by an API function.
+    *
+    * @param function The name of the function.
+    * @return The prefix, for example "Entropy::run : ".
+    */
+    std::string msgPrefix(const char *function)
+    {
+        std::string prefix(MODULE_NAME);
+        prefix += "::";
+        prefix += function;
+        prefix += " : ";
+        return prefix;
+    }
+
+    /**
+    * Counts a file that could not be analyzed. Called while handling an 
+    * exception, so it never throws.
+    */
+    void addFailure()
+    {
+        try
+        {
+            currentContext().statistics().addFailure();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /**
+    * Passes a buffer of file content to the byte histogram and to the 
+    * content analyzers.
+    */
+    void addContent(EntropyModule::ByteHistogram &histogram, const std::vector<EntropyModule::ContentAnalyzer*> &analyzers, const char *data, size_t length)
+    {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t*>(data);
+        histogram.add(bytes, length);
+        for (size_t i = 0; i < analyzers.size(); ++i)
+        {
+            analyzers[i]->add(bytes, length);
+        }
+    }
+
+    /**
+    * Counts a hole in a sparse file, which reads as zeros, without reading
+    * it. Analyzers are still given the zeros, since they depend on the 
+    * content in order.
+    */
+    void addHole(EntropyModule::ByteHistogram &histogram, const std::vector<EntropyModule::ContentAnalyzer*> &analyzers, uint64_t length)
+    {
+        static const uint8_t zeros[64 * 1024] = { 0 };
+
+        histogram.addRun(0, length);
+        for (size_t i = 0; i < analyzers.size(); ++i)
+        {
+            for (uint64_t remaining = length; remaining > 0; )
+            {
+                size_t part = static_cast<size_t>(std::min<uint64_t>(remaining, sizeof(zeros)));
+                analyzers[i]->add(zeros, part);
+                remaining -= part;
+            }
+        }
+    }
+
+    /**
+    * @return The path of a file's local copy, or an empty string if it has 
+    * none.
+    */
+    std::string localCopyPath(TskFile *pFile)
+    {
+        try
+        {
+            return pFile->exists() ? pFile->getPath() : std::string();
+        }
+        catch (TskException &)
+        {
+            return std::string();
+        }
+    }
+
+    /**
+    * Opens the local copy of a file for mapping, if the file has one of the
+    * expected size.
+    *
+    * @return False if the file's content has to be read through the 
+    * TskFile instead.
+    */
+    bool mapLocalFile(TskFile *pFile, uint64_t fileSize, bool dropPages, EntropyModule::MappedFile &mappedFile)
+    {
+        std::string path = localCopyPath(pFile);
+        return !path.empty() && mappedFile.open(path, dropPages) && mappedFile.size() == fileSize;
+    }
+
+    /**
+    * Opens the local copy of a file for reading with the configured I/O 
+    * policy, if the policy asks for it and the file has a copy of the 
+    * expected size.
+    *
+    * @return False if the file's content has to be read through the 
+    * TskFile instead.
+    */
+    bool openLocalFile(TskFile *pFile, uint64_t fileSize, EntropyModule::ModuleConfig::IoPolicy policy, 
+        EntropyModule::LocalFileReader &localFile)
+    {
+        if (policy == EntropyModule::ModuleConfig::IO_FRAMEWORK)
+        {
+            return false;
+        }
+
+        EntropyModule::LocalFileReader::Caching caching = EntropyModule::LocalFileReader::CACHE_NORMALLY;
+        if (policy == EntropyModule::ModuleConfig::IO_NOREUSE)
+        {
+            caching = EntropyModule::LocalFileReader::DROP_AFTER_READ;
+        }
+        else if (policy == EntropyModule::ModuleConfig::IO_DIRECT)
+        {
+            caching = EntropyModule::LocalFileReader::BYPASS_CACHE;
+        }
+
+        std::string path = localCopyPath(pFile);
+        return !path.empty() && localFile.open(path, caching) && localFile.size() == fileSize;
+    }
+
+    /**
+    * Counts the bytes of a file on the GPU, unless the device is busy or 
+    * fails.
+    *
+    * @return False if the file has to be counted on the CPU instead, in 
+    * which case its read cursor is back at the start.
+    * @throws TskException if the file cannot be read.
+    */
+    bool countOnGpu(TskFile *pFile, EntropyModule::GpuCounter *pGpuCounter, uint64_t fileSize, 
+        EntropyModule::ByteHistogram &histogram, EntropyModule::FileStatistics &statistics)
+    {
+        EntropyModule::TskFilePositionalReader reader(pFile);
+        Poco::Timestamp mark;
+        bool counted = pGpuCounter->count(reader, fileSize, histogram);
+
+        // The device counts while the next buffer is read, so whatever time
+        // the reads leave is spent waiting for it.
+        Poco::Timestamp::TimeDiff elapsed = mark.elapsed();
+        statistics.bytesRead += reader.bytesRead();
+        statistics.readCalls += reader.readCalls();
+        statistics.readTime += reader.readTime();
+        statistics.countTime += elapsed > reader.readTime() ? elapsed - reader.readTime() : 0;
+        if (!counted)
+        {
+            histogram.clear();
+            pFile->seek(0, SEEK_SET);
+        }
+
+        return counted;
+    }
+
+    /**
+    * Lets the analyzers know the content has ended and calculates the 
+    * entropy of the counted bytes.
+    */
+    double finishEntropy(const std::vector<EntropyModule::ContentAnalyzer*> &analyzers, EntropyModule::ByteHistogram &histogram, 
+        EntropyModule::FileStatistics &statistics)
+    {
+        Poco::Timestamp mark;
+        for (size_t i = 0; i < analyzers.size(); ++i)
+        {
+            analyzers[i]->finish();
+        }
+
+        statistics.countTime += mark.elapsed();
+
+        mark.update();
+        double entropy = EntropyModule::shannonEntropy(histogram.counts(), histogram.total());
+        statistics.reduceTime += mark.elapsed();
+        return entropy;
+    }
+
+    /**
+    * Calculates the entropy of a file.
+    *
+    * @param pFile A TskFile object corrersponding to a file.
+    * @param config The module settings.
+    * @param pScheduler The scheduler for counting large files in parallel, 
+    * or NULL.
+    * @param pGpuCounter The counter for counting large files on the GPU, or
+    * NULL.
+    * @param analyzers Analyzers that are given the file's content in order,
+    * in the same pass that counts its bytes.
+    * @param buffer The buffer to read into, resized as needed.
+    * @param scratch A histogram for counting chunks of large files. Its 
+    * content is lost.
+    * @param budget Limits the bytes read and the time spent. Only the bytes
+    * read within it are counted.
+    * @param histogram Receives the counts of the file's bytes.
+    * @param statistics Receives the work done for the file.
+    * @return The entropy of the file.
+    */
+    double calculateEntropy(TskFile *pFile, const EntropyModule::ModuleConfig &config, EntropyModule::ChunkScheduler *pScheduler, 
+        EntropyModule::GpuCounter *pGpuCounter, const std::vector<EntropyModule::ContentAnalyzer*> &analyzers, EntropyModule::AlignedBuffer &buffer, 
+        EntropyModule::ByteHistogram &scratch, EntropyModule::ReadBudget &budget, EntropyModule::ByteHistogram &histogram, 
+        EntropyModule::FileStatistics &statistics)
+    {
+        // Don't allocate more buffer than the file can fill. One byte of 
+        // headroom lets the whole file be read in one call.
+        size_t bufferSize = config.bufferSize;
+        TSK_OFF_T fileSize = pFile->getSize();
+        if (fileSize >= 0 && static_cast<uint64_t>(fileSize) < bufferSize)
+        {
+            bufferSize = (static_cast<size_t>(fileSize) + EntropyModule::AlignedBuffer::ALIGNMENT) & 
+                ~static_cast<size_t>(EntropyModule::AlignedBuffer::ALIGNMENT - 1);
+        }
+
+        // Files read in one call or in parallel are cut to the budget's 
+        // bytes up front.
+        uint64_t countSize = fileSize > 0 ? budget.limit(static_cast<uint64_t>(fileSize)) : 0;
+
+        histogram.clear();
+        EntropyModule::MappedFile mappedFile;
+        EntropyModule::LocalFileReader localFile;
+        Poco::Timestamp mark;
+        if (fileSize > 0 && static_cast<uint64_t>(fileSize) <= config.smallFileSize)
+        {
+            // Read the whole file with one call sized from its metadata. 
+            // Once the expected number of bytes has arrived there is no need
+            // for another call to find the end of the file.
+            statistics.mode = EntropyModule::FileStatistics::SMALL_FILE;
+            size_t size = static_cast<size_t>(countSize);
+            buffer.resize(size);
+            size_t total = 0;
+            mark.update();
+            while (total < size)
+            {
+                ++statistics.readCalls;
+                ssize_t bytesRead = pFile->read(buffer.data() + total, size - total);
+                if (bytesRead <= 0)
+                {
+                    break;
+                }
+
+                total += static_cast<size_t>(bytesRead);
+            }
+
+            statistics.readTime += mark.elapsed();
+            statistics.bytesRead += total;
+            budget.charge(total);
+
+            mark.update();
+            const uint8_t *bytes = reinterpret_cast<const uint8_t*>(buffer.data());
+            histogram.addSmall(bytes, total);
+            for (size_t i = 0; i < analyzers.size(); ++i)
+            {
+                analyzers[i]->add(bytes, total);
+            }
+
+            statistics.countTime += mark.elapsed();
+        }
+        else if (pGpuCounter != NULL && analyzers.empty() && countSize > config.gpuThreshold && 
+            countOnGpu(pFile, pGpuCounter, countSize, histogram, statistics))
+        {
+            // Counting on the GPU leaves the CPU free. Analyzers need the 
+            // content on the CPU, so they rule this out.
+            statistics.mode = EntropyModule::FileStatistics::GPU;
+            budget.charge(histogram.total());
+        }
+        else if (pScheduler != NULL && analyzers.empty() && countSize > config.chunkThreshold)
+        {
+            // Histograms of byte ranges simply add up, so count the chunks 
+            // on several threads. Analyzers need the content in order, so 
+            // they rule this out.
+            statistics.mode = EntropyModule::FileStatistics::CHUNKED;
+            EntropyModule::TskFilePositionalReader reader(pFile);
+            mark.update();
+            pScheduler->count(reader, countSize, buffer, scratch, histogram);
+            budget.charge(histogram.total());
+
+            // The reads are serialized, so whatever time they leave is spent
+            // counting.
+            Poco::Timestamp::TimeDiff elapsed = mark.elapsed();
+            statistics.bytesRead += reader.bytesRead();
+            statistics.readCalls += reader.readCalls();
+            statistics.readTime += reader.readTime();
+            statistics.countTime += elapsed > reader.readTime() ? elapsed - reader.readTime() : 0;
+        }
+        else if (config.mapFiles && fileSize > 0 && mapLocalFile(pFile, static_cast<uint64_t>(fileSize), 
+            config.ioPolicy == EntropyModule::ModuleConfig::IO_NOREUSE || config.ioPolicy == EntropyModule::ModuleConfig::IO_DIRECT, mappedFile))
+        {
+            // Count the local copy of the file straight from its mapping. 
+            // Page faults are taken while counting, so the time spent 
+            // reading only covers setting up the mappings. Holes in a sparse
+            // copy are counted as zeros without being mapped.
+            statistics.mode = EntropyModule::FileStatistics::MAPPED;
+            std::vector<EntropyModule::FileRange> ranges;
+            mappedFile.dataRanges(ranges);
+            EntropyModule::FileRange end = { mappedFile.size(), 0 };
+            ranges.push_back(end);
+
+            uint64_t position = 0;
+            for (size_t i = 0; i < ranges.size() && !budget.exhausted(); ++i)
+            {
+                if (ranges[i].offset > position)
+                {
+                    uint64_t holeLength = budget.limit(ranges[i].offset - position);
+                    mark.update();
+                    addHole(histogram, analyzers, holeLength);
+                    statistics.countTime += mark.elapsed();
+                    statistics.holeBytes += holeLength;
+                    budget.charge(holeLength);
+                }
+
+                uint64_t rangeEnd = ranges[i].offset + ranges[i].length;
+                size_t length = 0;
+                for (uint64_t offset = ranges[i].offset; offset < rangeEnd; offset += length)
+                {
+                    length = static_cast<size_t>(budget.limit(std::min<uint64_t>(config.mapWindow, rangeEnd - offset)));
+                    if (length == 0)
+                    {
+                        break;
+                    }
+
+                    mark.update();
+                    const char *data = mappedFile.map(offset, length);
+                    statistics.readTime += mark.elapsed();
+                    ++statistics.readCalls;
+
+                    mark.update();
+                    addContent(histogram, analyzers, data, length);
+                    statistics.countTime += mark.elapsed();
+                    statistics.bytesRead += length;
+                    budget.charge(length);
+                }
+
+                position = std::max(position, rangeEnd);
+            }
+        }
+        else if (config.readAheadDepth > 0 && fileSize > static_cast<TSK_OFF_T>(bufferSize))
+        {
+            // Read the file on another thread while this one counts. Each 
+            // buffer is filled by one read call, and the time spent waiting
+            // for it is charged to reading.
+            statistics.mode = EntropyModule::FileStatistics::READ_AHEAD;
+            EntropyModule::ReadPipeline pipeline(pFile, bufferSize, config.readAheadDepth);
+            const char *data = NULL;
+            size_t length = 0;
+            for (;;)
+            {
+                uint64_t allowed = budget.limit(bufferSize);
+                if (allowed == 0)
+                {
+                    break;
+                }
+
+                mark.update();
+                length = pipeline.next(data);
+                statistics.readTime += mark.elapsed();
+                ++statistics.readCalls;
+                if (length == 0)
+                {
+                    break;
+                }
+
+                length = static_cast<size_t>(std::min<uint64_t>(length, allowed));
+                mark.update();
+                addContent(histogram, analyzers, data, length);
+                statistics.countTime += mark.elapsed();
+                statistics.bytesRead += length;
+                budget.charge(length);
+            }
+        }
+        else if (fileSize > 0 && openLocalFile(pFile, static_cast<uint64_t>(fileSize), config.ioPolicy, localFile))
+        {
+            // Read the local copy directly, so the system can be told how it
+            // is read and cached. The buffer size is a multiple of the 
+            // alignment unbuffered reads need.
+            statistics.mode = EntropyModule::FileStatistics::SEQUENTIAL;
+            buffer.resize(bufferSize);
+            // Whole buffers are read so unbuffered reads stay aligned, and 
+            // only what the budget allows of the last one is counted.
+            size_t bytesRead = 0;
+            do
+            {
+                uint64_t allowed = budget.limit(buffer.size());
+                if (allowed == 0)
+                {
+                    break;
+                }
+
+                mark.update();
+                bytesRead = localFile.read(buffer.data(), buffer.size());
+                statistics.readTime += mark.elapsed();
+                ++statistics.readCalls;
+                if (bytesRead > 0)
+                {
+                    size_t length = static_cast<size_t>(std::min<uint64_t>(bytesRead, allowed));
+                    mark.update();
+                    addContent(histogram, analyzers, buffer.data(), length);
+                    statistics.countTime += mark.elapsed();
+                    statistics.bytesRead += bytesRead;
+                    budget.charge(length);
+                }
+            } 
+            while (bytesRead > 0);
+        }
+        else
+        {
+            statistics.mode = EntropyModule::FileStatistics::SEQUENTIAL;
+            buffer.resize(bufferSize);
+            ssize_t bytesRead = 0;
+            do
+            {
+                size_t length = static_cast<size_t>(budget.limit(buffer.size()));
+                if (length == 0)
+                {
+                    break;
+                }
+
+                mark.update();
+                bytesRead = pFile->read(buffer.data(), length);
+                statistics.readTime += mark.elapsed();
+                ++statistics.readCalls;
+                if (bytesRead > 0)
+                {
+                    mark.update();
+                    addContent(histogram, analyzers, buffer.data(), static_cast<size_t>(bytesRead));
+                    statistics.countTime += mark.elapsed();
+                    statistics.bytesRead += static_cast<uint64_t>(bytesRead);
+                    budget.charge(static_cast<uint64_t>(bytesRead));
+                }
+            } 
+            while (bytesRead > 0);
+        }
+
+        return finishEntropy(analyzers, histogram, statistics);
+    }
+
+    /**
+    * Calculates the entropy of content produced by a content source rather
+    * than read from a file.
+    *
+    * @param source The source of the content.
+    * @param analyzers Analyzers that are given the content in order, in the
+    * same pass that counts its bytes.
+    * @param budget Limits the bytes produced and the time spent. Only the 
+    * bytes produced within it are counted.
+    * @param histogram Receives the counts of the content's bytes.
+    * @param statistics Receives the work done for the content. The time the
+    * source takes to produce the content is charged to reading.
+    * @return The entropy of the content.
+    */
+    double streamEntropy(EntropyModule::ContentSource &source, const std::vector<EntropyModule::ContentAnalyzer*> &analyzers, 
+        EntropyModule::ReadBudget &budget, EntropyModule::ByteHistogram &histogram, EntropyModule::FileStatistics &statistics)
+    {
+        statistics.mode = EntropyModule::FileStatistics::STREAMED;
+        histogram.clear();
+        Poco::Timestamp mark;
+        const char *data = NULL;
+        size_t length = 0;
+        for (;;)
+        {
+            uint64_t allowed = budget.limit(std::numeric_limits<uint64_t>::max());
+            if (allowed == 0)
+            {
+                break;
+            }
+
+            mark.update();
+            length = source.next(data);
+            statistics.readTime += mark.elapsed();
+            ++statistics.readCalls;
+            if (length == 0)
+            {
+                break;
+            }
+
+            length = static_cast<size_t>(std::min<uint64_t>(length, allowed));
+            mark.update();
+            addContent(histogram, analyzers, data, length);
+            statistics.countTime += mark.elapsed();
+            statistics.bytesRead += length;
+            budget.charge(length);
+        }
+
+        return finishEntropy(analyzers, histogram, statistics);
+    }
+
+    /**
+    * Adds a file's whole-file results to the attributes to be posted.
+    */
+    void collectResult(const EntropyModule::EntropyResult &result, EntropyModule::ResultAttributes &attributes)
+    {
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_ENTROPY, "", result.entropy));
+        if (result.sampled)
+        {
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_FLAG, "sampled", 1));
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "sample_coverage", result.sampleCoverage));
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "sample_interval_width", result.sampleIntervalWidth));
+        }
+
+        if (result.partial)
+        {
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_FLAG, "partial", 1));
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "partial_bytes", result.bytesCounted));
+        }
+    }
+
+    /**
+    * Adds the band the entropy of a file falls in to the attributes to be
+    * posted, if requested by the settings.
+    */
+    void collectBand(const EntropyModule::ModuleConfig &config, double entropy, EntropyModule::ResultAttributes &attributes)
+    {
+        if (!config.postBand)
+        {
+            return;
+        }
+
+        const char *band = "low";
+        if (entropy >= config.bandEncrypted)
+        {
+            band = "encrypted";
+        }
+        else if (entropy >= config.bandCompressed)
+        {
+            band = "compressed";
+        }
+        else if (entropy >= config.bandText)
+        {
+            band = "text";
+        }
+
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "entropy_band", std::string(band)));
+    }
+
+    /**
+    * Adds the summary of a file's block entropy profile to the attributes to
+    * be posted.
+    */
+    void collectBlockProfile(const EntropyModule::BlockProfile &profile, EntropyModule::ResultAttributes &attributes)
+    {
+        if (profile.blockCount() == 0)
+        {
+            return;
+        }
+
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_ENTROPY, "block_min", profile.minimum()));
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_ENTROPY, "block_max", profile.maximum()));
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_ENTROPY, "block_mean", profile.mean()));
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "block_variance", profile.variance()));
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "block_count", profile.blockCount()));
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "blocks_above_threshold", profile.highEntropyBlockCount()));
+        if (!profile.series().empty())
+        {
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "block_series", profile.series()));
+        }
+    }
+
+    /**
+    * Saves a file's entropy pyramid in the pyramid directory and adds its 
+    * path to the attributes to be posted. The pyramid is named after the
+    * file's content hash, which the result cache shares the path by, or 
+    * failing that after the file's ID, and after the pyramid's settings.
+    *
+    * @throws TskException if the pyramid cannot be saved.
+    */
+    void collectPyramid(const EntropyModule::EntropyPyramid &pyramid, TskFile *pFile, EntropyModule::ResultAttributes &attributes)
+    {
+        if (pyramid.size() == 0)
+        {
+            return;
+        }
+
+        std::string hash = EntropyModule::ResultCache::contentHash(pFile);
+        std::replace(hash.begin(), hash.end(), ':', '-');
+        std::ostringstream name;
+        if (!hash.empty() && hash.find_first_of("/\\.") == std::string::npos)
+        {
+            name << hash;
+        }
+        else
+        {
+            name << "id-" << pFile->getId();
+        }
+
+        name << "-" << moduleConfig.pyramidBlockSize << "x" << moduleConfig.pyramidLevels << ".entpyr";
+        std::string path = Poco::Path(Poco::Path::forDirectory(moduleConfig.pyramidDir), name.str()).toString();
+        pyramid.save(path);
+        attributes.push_back(EntropyModule::ResultAttribute(TSK_PATH, "entropy_pyramid", path));
+    }
+
+    /**
+    * @return False if the attributes name a pyramid file that no longer 
+    * exists, such as cached results from a run whose pyramid directory has
+    * been cleared since, in which case the file is analyzed again.
+    */
+    bool hasPyramidFile(const EntropyModule::ResultAttributes &attributes)
+    {
+        if (moduleConfig.pyramidDir.empty())
+        {
+            return true;
+        }
+
+        for (size_t i = 0; i < attributes.size(); ++i)
+        {
+            if (attributes[i].attributeType == TSK_PATH && attributes[i].context == "entropy_pyramid")
+            {
+                return Poco::File(attributes[i].stringValue).exists();
+            }
+        }
+
+        return true;
+    }
+
+    /**
+    * Adds the randomness statistics and the byte histogram requested by the
+    * settings to the attributes to be posted.
+    */
+    void collectStatistics(const EntropyModule::ModuleConfig &config, EntropyModule::ByteHistogram &histogram, 
+        const EntropyModule::SerialCorrelation *pSerialCorrelation, const EntropyModule::MonteCarloPi *pMonteCarloPi, 
+        EntropyModule::ResultAttributes &attributes)
+    {
+        const uint64_t *counts = histogram.counts();
+        uint64_t total = histogram.total();
+        if (total == 0)
+        {
+            return;
+        }
+
+        // The collision and min entropies come from the same counts as the
+        // Shannon entropy, so they cost no extra reading.
+        if (config.renyiEntropy)
+        {
+            double collision = 0.0;
+            double minimum = 0.0;
+            EntropyModule::renyiEntropies(counts, total, collision, minimum);
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_ENTROPY, "collision_entropy", collision));
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_ENTROPY, "min_entropy", minimum));
+        }
+
+        if (config.chiSquare)
+        {
+            double statistic = EntropyModule::chiSquare(counts, total);
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "chi_square", statistic));
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "chi_square_probability", EntropyModule::chiSquareProbability(statistic, 255)));
+        }
+
+        if (config.mean)
+        {
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "mean", EntropyModule::arithmeticMean(counts, total)));
+        }
+
+        double value = 0.0;
+        if (pSerialCorrelation != NULL && pSerialCorrelation->coefficient(counts, total, value))
+        {
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "serial_correlation", value));
+        }
+
+        if (pMonteCarloPi != NULL && pMonteCarloPi->estimate(value))
+        {
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "monte_carlo_pi", value));
+        }
+
+        if (config.postHistogram)
+        {
+            std::vector<unsigned char> encoded;
+            EntropyModule::encodeHistogram(counts, encoded);
+            attributes.push_back(EntropyModule::ResultAttribute(TSK_VALUE, "byte_histogram", encoded));
+        }
+    }
+
+    /**
+    * Checks that a file's results can be posted, so that a batch posts 
+    * only files whose attributes are known to be valid.
+    *
+    * @throws TskException if an attribute has an unknown type of value or
+    * a value that is not a finite number.
+    */
+    void checkAttributes(const EntropyModule::ResultAttributes &attributes)
+    {
+        for (size_t i = 0; i < attributes.size(); ++i)
+        {
+            const EntropyModule::ResultAttribute &attribute = attributes[i];
+            switch (attribute.valueType)
+            {
+            case EntropyModule::ResultAttribute::DOUBLE:
+                if (!(attribute.doubleValue >= -std::numeric_limits<double>::max() && attribute.doubleValue <= std::numeric_limits<double>::max()))
+                {
+                    throw TskException("attribute " + attribute.context + " is not a finite number");
+                }
+                break;
+            case EntropyModule::ResultAttribute::INTEGER:
+            case EntropyModule::ResultAttribute::LONG:
+            case EntropyModule::ResultAttribute::STRING:
+            case EntropyModule::ResultAttribute::BYTES:
+                break;
+            default:
+                throw TskException("attribute " + attribute.context + " has an unknown type of value");
+            }
+        }
+    }
+
+    /**
+    * Posts a file's results to the blackboard.
+    */
+    void postAttributes(TskFile *pFile, const EntropyModule::ResultAttributes &attributes)
+    {
+        for (size_t i = 0; i < attributes.size(); ++i)
+        {
+            const EntropyModule::ResultAttribute &attribute = attributes[i];
+            TSK_ATTRIBUTE_TYPE type = static_cast<TSK_ATTRIBUTE_TYPE>(attribute.attributeType);
+            switch (attribute.valueType)
+            {
+            case EntropyModule::ResultAttribute::INTEGER:
+                pFile->addGenInfoAttribute(TskBlackboardAttribute(type, MODULE_NAME, attribute.context, attribute.intValue));
+                break;
+            case EntropyModule::ResultAttribute::LONG:
+                pFile->addGenInfoAttribute(TskBlackboardAttribute(type, MODULE_NAME, attribute.context, attribute.longValue));
+                break;
+            case EntropyModule::ResultAttribute::DOUBLE:
+                pFile->addGenInfoAttribute(TskBlackboardAttribute(type, MODULE_NAME, attribute.context, attribute.doubleValue));
+                break;
+            case EntropyModule::ResultAttribute::STRING:
+                pFile->addGenInfoAttribute(TskBlackboardAttribute(type, MODULE_NAME, attribute.context, attribute.stringValue));
+                break;
+            case EntropyModule::ResultAttribute::BYTES:
+                pFile->addGenInfoAttribute(TskBlackboardAttribute(type, MODULE_NAME, attribute.context, attribute.bytesValue));
+                break;
+            }
+        }
+    }
+    /**
+    * Calculates the entropy of a file, counting only the bytes after the 
+    * point stored for it if the file's content up to that point is 
+    * unchanged, and stores the point reached for the next time. The file 
+    * is read in order, so the fingerprint of the point reached is hashed 
+    * as the file is counted.
+    *
+    * @param pFile The file.
+    * @param context The calling thread's context.
+    * @param budget Limits the bytes read and the time spent.
+    * @param statistics Receives the I/O statistics of the file.
+    * @return The entropy of the file.
+    * @throws TskException if the file cannot be read.
+    */
+    double resumeEntropy(TskFile *pFile, EntropyModule::ThreadContext &context, EntropyModule::ReadBudget &budget, 
+        EntropyModule::FileStatistics &statistics)
+    {
+        const std::vector<EntropyModule::ContentAnalyzer*> noAnalyzers;
+        EntropyModule::AlignedBuffer &buffer = context.buffer();
+        EntropyModule::ByteHistogram &histogram = context.histogram();
+        TSK_OFF_T size = pFile->getSize();
+        std::string key = EntropyModule::ResumeStore::makeKey(pFile);
+        if (key.empty() || size <= static_cast<TSK_OFF_T>(EntropyModule::ResumeStore::MIN_FILE_SIZE))
+        {
+            return calculateEntropy(pFile, moduleConfig, chunkScheduler, gpuCounter, noAnalyzers, buffer, context.scratch(), budget, histogram, statistics);
+        }
+
+        uint64_t fileSize = static_cast<uint64_t>(size);
+        int64_t modified = pFile->getMtime();
+        EntropyModule::TskFilePositionalReader reader(pFile);
+        EntropyModule::ResumePoint point;
+        EntropyModule::PrefixHash hash;
+        buffer.resize(moduleConfig.bufferSize);
+        histogram.clear();
+        if (resumeStore->find(key, point) && EntropyModule::ResumeStore::isCandidate(point, fileSize, modified) && 
+            EntropyModule::ResumeStore::fingerprint(reader, point.offset, buffer, hash) == point.fingerprint)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix("resumeEntropy") << "resuming " << key << " after " << point.offset << " unchanged bytes";
+            LOGINFO(msg.str());
+
+            // Start from the counts of the unchanged prefix.
+            for (int value = 0; value < 256; ++value)
+            {
+                histogram.addRun(static_cast<uint8_t>(value), point.counts[value]);
+            }
+
+            statistics.mode = EntropyModule::FileStatistics::RESUMED;
+        }
+        else
+        {
+            point.offset = 0;
+            hash = EntropyModule::PrefixHash();
+            statistics.mode = EntropyModule::FileStatistics::SEQUENTIAL;
+        }
+
+        // Count the rest of the file, hashing it for the next point.
+        Poco::Timestamp mark;
+        Poco::Timestamp::TimeDiff readTime = reader.readTime();
+        for (uint64_t offset = point.offset; offset < fileSize; )
+        {
+            size_t length = static_cast<size_t>(budget.limit(std::min<uint64_t>(buffer.size(), fileSize - offset)));
+            size_t bytesRead = length > 0 ? reader.readAt(offset, buffer.data(), length) : 0;
+            if (bytesRead == 0)
+            {
+                break;
+            }
+
+            const uint8_t *bytes = reinterpret_cast<const uint8_t*>(buffer.data());
+            histogram.add(bytes, bytesRead);
+            hash.add(bytes, bytesRead);
+            budget.charge(bytesRead);
+            offset += bytesRead;
+        }
+
+        Poco::Timestamp::TimeDiff elapsed = mark.elapsed();
+        readTime = reader.readTime() - readTime;
+        double entropy = EntropyModule::shannonEntropy(histogram.counts(), histogram.total());
+        statistics.countTime += elapsed > readTime ? elapsed - readTime : 0;
+
+        // Only a point covering the whole file is worth storing; a file that
+        // ended early is counted again next time. The point of a file that
+        // has not changed is already stored.
+        const uint64_t *counts = histogram.counts();
+        if (histogram.total() == fileSize && point.offset != fileSize)
+        {
+            point.offset = fileSize;
+            point.modified = modified;
+            std::copy(counts, counts + 256, point.counts);
+            point.fingerprint = hash.value();
+            resumeStore->add(key, point);
+        }
+
+        // The reader's totals include the reads made to check the 
+        // fingerprint.
+        statistics.bytesRead += reader.bytesRead();
+        statistics.readCalls += reader.readCalls();
+        statistics.readTime += reader.readTime();
+
+        return entropy;
+    }
+
+    /**
+    * Lends the calling thread to the chunks of large files other threads are
+    * waiting for, now that its own file is done.
+    */
+    void helpWithChunks(EntropyModule::ThreadContext &context)
+    {
+        if (chunkScheduler != NULL && moduleConfig.chunkHelp > 0)
+        {
+            chunkScheduler->help(moduleConfig.chunkHelp, context.buffer(), context.scratch());
+        }
+    }
+
+    /**
+    * Analyzes a file and gathers the attributes to post for it, taking them
+    * from the result cache when possible.
+    *
+    * @param pFile The file.
+    * @param pSource The source of the file's content, or NULL to read the 
+    * content from the file.
+    * @param context The calling thread's context.
+    * @param attributes Receives the attributes.
+    * @throws TskException if the file cannot be analyzed.
+    */
+    void analyzeFile(TskFile *pFile, EntropyModule::ContentSource *pSource, EntropyModule::ThreadContext &context, 
+        EntropyModule::ResultAttributes &attributes)
+    {
+        Poco::Timestamp started;
+
+        // Decide what to do with the file before reading any of it.
+        EntropyModule::FileStatistics fileStatistics;
+        EntropyModule::Admission admission = EntropyModule::admitFile(pFile, moduleConfig);
+        if (admission == EntropyModule::ADMIT_SKIP)
+        {
+            fileStatistics.mode = EntropyModule::FileStatistics::SKIPPED;
+            context.statistics().addFile(fileStatistics, started.elapsed());
+            return;
+        }
+
+        // Files with the same content as one already analyzed get that
+        // file's results without being read.
+        std::string cacheKey;
+        if (resultCache != NULL)
+        {
+            cacheKey = EntropyModule::ResultCache::makeKey(pFile, resultSignature);
+            if (!cacheKey.empty() && resultCache->find(cacheKey, attributes))
+            {
+                if (hasPyramidFile(attributes))
+                {
+                    fileStatistics.mode = EntropyModule::FileStatistics::CACHED;
+                    context.statistics().addFile(fileStatistics, started.elapsed());
+                    return;
+                }
+
+                attributes.clear();
+            }
+        }
+
+        // The thread's analyzers are reused from file to file.
+        const std::vector<EntropyModule::ContentAnalyzer*> &analyzers = context.resetAnalyzers(moduleConfig);
+
+        EntropyModule::EntropyResult result;
+        EntropyModule::ByteHistogram &histogram = context.histogram();
+        EntropyModule::ReadBudget budget(moduleConfig.maxBytes, 
+            static_cast<Poco::Timestamp::TimeDiff>(moduleConfig.maxSeconds * Poco::Timestamp::resolution()));
+        if (pSource != NULL)
+        {
+            // Content handed over by another module can only be read in 
+            // order, so it is counted from the start and the file is never
+            // read.
+            result.entropy = streamEntropy(*pSource, analyzers, budget, histogram, fileStatistics);
+        }
+        else if (admission == EntropyModule::ADMIT_SAMPLE)
+        {
+            // Estimate the entropy of a large file from a sample of it.
+            TSK_OFF_T fileSize = pFile->getSize();
+            EntropyModule::TskFilePositionalReader reader(pFile);
+            EntropyModule::EntropySampler &sampler = context.resetSampler(moduleConfig);
+            Poco::Timestamp mark;
+            histogram.clear();
+            sampler.estimate(reader, static_cast<uint64_t>(fileSize), context.buffer(), histogram, result);
+            Poco::Timestamp::TimeDiff elapsed = mark.elapsed();
+            fileStatistics.mode = EntropyModule::FileStatistics::SAMPLED;
+            fileStatistics.bytesRead = reader.bytesRead();
+            fileStatistics.readCalls = reader.readCalls();
+            fileStatistics.readTime = reader.readTime();
+            fileStatistics.countTime = elapsed > reader.readTime() ? elapsed - reader.readTime() : 0;
+        }
+        else if (resumeStore != NULL && analyzers.empty())
+        {
+            // Count only what was added to the file since it was last 
+            // analyzed. The analyzers need the file's content from the
+            // start, so they rule this out.
+            result.entropy = resumeEntropy(pFile, context, budget, fileStatistics);
+        }
+        else
+        {
+            // Calculate an entropy value for the file, and any other 
+            // statistics, in one pass over its content.
+            result.entropy = calculateEntropy(pFile, moduleConfig, chunkScheduler, gpuCounter, analyzers, context.buffer(), 
+                context.scratch(), budget, histogram, fileStatistics);
+        }
+
+        // A file whose reading was cut short by the budget is reported as
+        // partial. A sampled file is never budgeted.
+        TSK_OFF_T size = pFile->getSize();
+        if (budget.exhausted() && (size <= 0 || histogram.total() < static_cast<uint64_t>(size)))
+        {
+            result.partial = true;
+            result.bytesCounted = histogram.total();
+        }
+
+        // Gather the values to post to the blackboard.
+        Poco::Timestamp mark;
+        collectResult(result, attributes);
+        collectBand(moduleConfig, result.entropy, attributes);
+        collectStatistics(moduleConfig, histogram, context.serialCorrelation(), context.monteCarloPi(), attributes);
+        if (context.blockProfile() != NULL)
+        {
+            collectBlockProfile(*context.blockProfile(), attributes);
+        }
+
+        if (context.pyramid() != NULL)
+        {
+            collectPyramid(*context.pyramid(), pFile, attributes);
+        }
+
+        fileStatistics.reduceTime += mark.elapsed();
+
+        // The results of a partial file would hide a full analysis of the
+        // same content, so they are not remembered.
+        if (!cacheKey.empty() && !result.partial)
+        {
+            resultCache->add(cacheKey, attributes);
+        }
+
+        context.statistics().addFile(fileStatistics, started.elapsed());
+    }
+}
+
+extern "C" 
+{
+    /**
+    * Module identification function. 
+    *
+    * CAVEAT: This function is intended to be called by TSK Framework only. 
+    * Linux/OS-X modules should *not* call this function within the module 
+    * unless appropriate compiler/linker options are used to bind all 
+    * library-internal symbols at link time. 
+    *
+    * @return The name of the module.
+    */
+    TSK_MODULE_EXPORT const char *name()
+    {
+        return MODULE_NAME;
+    }
+
+    /**
+    * Module identification function. 
+    *
+    * CAVEAT: This function is intended to be called by TSK Framework only. 
+    * Linux/OS-X modules should *not* call this function within the module 
+    * unless appropriate compiler/linker options are used to bind all 
+    * library-internal symbols at link time. 
+    *
+    * @return A description of the module.
+    */
+    TSK_MODULE_EXPORT const char *description()
+    {
+        return MODULE_DESCRIPTION;
+    }
+
+    /**
+    * Module identification function. 
+    *
+    * CAVEAT: This function is intended to be called by TSK Framework only. 
+    * Linux/OS-X modules should *not* call this function within the module 
+    * unless appropriate compiler/linker options are used to bind all 
+    * library-internal symbols at link time. 
+    *
+    * @return The version of the module.
+    */
+    TSK_MODULE_EXPORT const char *version()
+    {
+        return MODULE_VERSION;
+    }
+
+    /**
+    * Module initialization function. Receives a string of initialization arguments, 
+    * typically read by the caller from a pipeline configuration file. 
+    * Returns TskModule::OK or TskModule::FAIL. Returning TskModule::FAIL indicates 
+    * the module is not in an operational state.  
+    *
+    * CAVEAT: This function is intended to be called by TSK Framework only. 
+    * Linux/OS-X modules should *not* call this function within the module 
+    * unless appropriate compiler/linker options are used to bind all 
+    * library-internal symbols at link time. 
+    *
+    * @param args a string of initialization arguments.
+    * @return TskModule::OK if initialization succeeded, otherwise TskModule::FAIL.
+    */
+    TskModule::Status TSK_MODULE_EXPORT initialize(const char* arguments)
+    {    
+        // The TSK Framework convention is to prefix error messages with the
+        // name of the module/class and the function that emitted the message. 
+        std::ostringstream msgPrefix;
+        msgPrefix << MODULE_NAME << "::initialize : ";
+
+        // Well-behaved modules should catch and log all possible exceptions
+        // and return an appropriate TskModule::Status to the TSK Framework. 
+        try
+        {
+            EntropyModule::ModuleConfig config;
+            EntropyModule::parseModuleConfig(arguments != NULL ? arguments : "", config);
+            moduleConfig = config;
+
+            delete chunkScheduler;
+            chunkScheduler = NULL;
+            if (config.chunkThreads > 0)
+            {
+                chunkScheduler = new EntropyModule::ChunkScheduler(config.chunkThreads, config.chunkSize, config.bufferSize);
+            }
+
+            delete gpuCounter;
+            gpuCounter = NULL;
+            if (config.gpuThreshold > 0)
+            {
+                std::string reason;
+                gpuCounter = EntropyModule::GpuCounter::create(reason);
+                if (gpuCounter == NULL)
+                {
+                    LOGINFO(msgPrefix.str() + "counting on the CPU because " + reason);
+                }
+            }
+
+            if (threadContexts == NULL)
+            {
+                threadContexts = new EntropyModule::ThreadContexts();
+            }
+
+            delete resultCache;
+            resultCache = NULL;
+            resultSignature = EntropyModule::resultSignature(config);
+            if (config.cacheEntries > 0)
+            {
+                std::auto_ptr<EntropyModule::ResultCache> cache(new EntropyModule::ResultCache(config.cacheEntries, config.cacheFile));
+                if (!cache->load())
+                {
+                    LOGWARN(msgPrefix.str() + "discarding corrupt result cache " + config.cacheFile);
+                }
+
+                resultCache = cache.release();
+            }
+
+            if (!config.pyramidDir.empty())
+            {
+                Poco::File(config.pyramidDir).createDirectories();
+            }
+
+            delete resumeStore;
+            resumeStore = NULL;
+            if (config.resumeEntries > 0)
+            {
+                std::auto_ptr<EntropyModule::ResumeStore> store(new EntropyModule::ResumeStore(config.resumeEntries, config.resumeFile));
+                if (!store->load())
+                {
+                    LOGWARN(msgPrefix.str() + "discarding corrupt resume store " + config.resumeFile);
+                }
+
+                resumeStore = store.release();
+            }
+
+            return TskModule::OK;
+        }
+        catch (TskException &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix.str() << "TskException: " << ex.message();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
+        //catch (Poco::Exception &ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix.str() << "Poco::Exception: " << ex.displayText();
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}
+        catch (std::exception &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix.str() << "std::exception: " << ex.what();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
+        //catch (System::Exception ^ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix.str() << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}        
+        catch (...)
+        {
+            LOGERROR(msgPrefix.str() + "unrecognized exception");
+            return TskModule::FAIL;
+        }
+    }
+
+    /**
+    * Module execution function for file analysis modules. 
+    * Receives a pointer to a file the module is to process. The file is 
+    * represented by a TskFile interface from which both file content and file 
+    * metadata can be retrieved. Returns TskModule::OK, TskModule::FAIL, or 
+    * TskModule::STOP. Returning TskModule::FAIL indicates the module 
+    * experienced an error processing the file. 
+    *
+    * CAVEAT: This function is intended to be called by TSK Framework only. 
+    * Linux/OS-X modules should *not* call this function within the module 
+    * unless appropriate compiler/linker options are used to bind all 
+    * library-internal symbols at link time. 
+    *
+    * @param pFile A pointer to a file to be processed.
+    * @returns TskModule::OK on success, TskModule::FAIL on error, or 
+    * TskModule::STOP. Returning TskModule::STOP is a request to terminate 
+    * processing of the file.     
+    */
+    TskModule::Status TSK_MODULE_EXPORT run(TskFile *pFile)
+    {
+        // The TSK Framework convention is to prefix error messages with the
+        // name of the module/class and the function that emitted the message.
+        // The prefix is only built when a message is logged, so analyzing a 
+        // file does not allocate memory for it.
+        const char *function = "run";
+
+        // Well-behaved modules should catch and log all possible exceptions
+        // and return an appropriate TskModule::Status to the TSK Framework. 
+        try
+        {
+            assert(pFile != NULL);
+            if (pFile == NULL) 
+            {
+                throw TskException("passed NULL TskFile pointer");
+            }
+
+            EntropyModule::ThreadContext &context = currentContext();
+            EntropyModule::ResultAttributes &attributes = context.attributes();
+            attributes.clear();
+            analyzeFile(pFile, NULL, context, attributes);
+            postAttributes(pFile, attributes);
+            helpWithChunks(context);
+
+            return TskModule::OK;
+        }
+        catch (TskException &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix(function) << "TskException: " << ex.message();
+            LOGERROR(msg.str());
+            addFailure();
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
+        //catch (Poco::Exception &ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix(function) << "Poco::Exception: " << ex.displayText();
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}
+        catch (std::exception &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix(function) << "std::exception: " << ex.what();
+            LOGERROR(msg.str());
+            addFailure();
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
+        //catch (System::Exception ^ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix(function) << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}        
+        catch (...)
+        {
+            LOGERROR(msgPrefix(function) + "unrecognized exception");
+            addFailure();
+            return TskModule::FAIL;
+        }
+    }
+
+    /**
+    * Streaming execution function. Analyzes content that another module 
+    * produces in memory, such as the decompressed content of an archive 
+    * member, as run() would analyze the content of the file it belongs to,
+    * and posts the attributes for that file. The content need not be 
+    * written to disk and read back. The file's size and known status still
+    * decide whether it is skipped, but it is never sampled or read.
+    *
+    * This function is not called by TSK Framework pipelines. It is meant 
+    * for modules and applications that load the module themselves and 
+    * include ContentSource.h.
+    *
+    * @param pFile The file the content belongs to.
+    * @param pSource The source of the content.
+    * @returns TskModule::OK on success, TskModule::FAIL on error.
+    */
+    TskModule::Status TSK_MODULE_EXPORT runContent(TskFile *pFile, EntropyModule::ContentSource *pSource)
+    {
+        // The TSK Framework convention is to prefix error messages with the
+        // name of the module/class and the function that emitted the message.
+        // The prefix is only built when a message is logged, so analyzing 
+        // content does not allocate memory for it.
+        const char *function = "runContent";
+
+        // Well-behaved modules should catch and log all possible exceptions
+        // and return an appropriate TskModule::Status to the TSK Framework. 
+        try
+        {
+            if (pFile == NULL) 
+            {
+                throw TskException("passed NULL TskFile pointer");
+            }
+
+            if (pSource == NULL) 
+            {
+                throw TskException("passed NULL ContentSource pointer");
+            }
+
+            EntropyModule::ThreadContext &context = currentContext();
+            EntropyModule::ResultAttributes &attributes = context.attributes();
+            attributes.clear();
+            analyzeFile(pFile, pSource, context, attributes);
+            postAttributes(pFile, attributes);
+            helpWithChunks(context);
+
+            return TskModule::OK;
+        }
+        catch (TskException &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix(function) << "TskException: " << ex.message();
+            LOGERROR(msg.str());
+            addFailure();
+            return TskModule::FAIL;
+        }
+        catch (std::exception &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix(function) << "std::exception: " << ex.what();
+            LOGERROR(msg.str());
+            addFailure();
+            return TskModule::FAIL;
+        }
+        catch (...)
+        {
+            LOGERROR(msgPrefix(function) + "unrecognized exception");
+            addFailure();
+            return TskModule::FAIL;
+        }
+    }
+
+    /**
+    * Batch execution function for file analysis modules. Analyzes a set of
+    * files the way run() analyzes one and checks their attributes, then 
+    * posts the attributes of all of them to the blackboard in a single 
+    * database transaction, which is always committed. A file that cannot
+    * be analyzed, or whose attributes cannot be posted, does not stop the
+    * others from being analyzed and posted, and exactly the files whose 
+    * attributes were all posted and committed are processed.
+    *
+    * This function is not called by TSK Framework pipelines. It is meant 
+    * for applications that load the module themselves and have many small 
+    * files to analyze, for which the per-file overhead of run() and of 
+    * committing each file's attributes separately dominates.
+    *
+    * @param files The files to be processed.
+    * @param count The number of files.
+    * @param statuses Receives the status of each file, TskModule::OK or
+    * TskModule::FAIL; may be NULL.
+    * @returns TskModule::OK if every file was processed, otherwise 
+    * TskModule::FAIL.
+    */
+    TskModule::Status TSK_MODULE_EXPORT runBatch(TskFile **files, size_t count, TskModule::Status *statuses)
+    {
+        // The TSK Framework convention is to prefix error messages with the
+        // name of the module/class and the function that emitted the message.
+        // The prefix is only built when a message is logged, so analyzing a 
+        // file does not allocate memory for it.
+        const char *function = "runBatch";
+
+        // Well-behaved modules should catch and log all possible exceptions
+        // and return an appropriate TskModule::Status to the TSK Framework. 
+        try
+        {
+            if (files == NULL && count > 0) 
+            {
+                throw TskException("passed NULL TskFile array");
+            }
+
+            EntropyModule::ThreadContext &context = currentContext();
+            std::vector<EntropyModule::ResultAttributes> results(count);
+            std::vector<bool> analyzed(count, false);
+            TskModule::Status status = TskModule::OK;
+            for (size_t i = 0; i < count; ++i)
+            {
+                try
+                {
+                    if (files[i] == NULL) 
+                    {
+                        throw TskException("passed NULL TskFile pointer");
+                    }
+
+                    analyzeFile(files[i], NULL, context, results[i]);
+                    checkAttributes(results[i]);
+                    analyzed[i] = true;
+                }
+                catch (TskException &ex)
+                {
+                    std::ostringstream msg;
+                    msg << msgPrefix(function) << "file " << i << ": TskException: " << ex.message();
+                    LOGERROR(msg.str());
+                    addFailure();
+                }
+                catch (std::exception &ex)
+                {
+                    std::ostringstream msg;
+                    msg << msgPrefix(function) << "file " << i << ": std::exception: " << ex.what();
+                    LOGERROR(msg.str());
+                    addFailure();
+                }
+                catch (...)
+                {
+                    std::ostringstream msg;
+                    msg << msgPrefix(function) << "file " << i << ": unrecognized exception";
+                    LOGERROR(msg.str());
+                    addFailure();
+                }
+
+            }
+
+            // Post everything in one transaction. If the transaction cannot 
+            // be started, the attributes are still posted, just not 
+            // together. The image database cannot roll a transaction back, 
+            // so a transaction is always committed, with whatever was 
+            // posted in it, rather than left open for the next commit on 
+            // the connection to pick up. A file whose attributes fail to be
+            // posted may have some of them committed, but is not processed.
+            TskImgDB &imgDB = TskServices::Instance().getImgDB();
+            bool transaction = imgDB.begin() == 0;
+            std::vector<bool> posted(count, false);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!analyzed[i])
+                {
+                    continue;
+                }
+
+                try
+                {
+                    postAttributes(files[i], results[i]);
+                    posted[i] = true;
+                }
+                catch (TskException &ex)
+                {
+                    std::ostringstream msg;
+                    msg << msgPrefix(function) << "file " << i << ": posting attributes: TskException: " << ex.message();
+                    LOGERROR(msg.str());
+                }
+                catch (std::exception &ex)
+                {
+                    std::ostringstream msg;
+                    msg << msgPrefix(function) << "file " << i << ": posting attributes: std::exception: " << ex.what();
+                    LOGERROR(msg.str());
+                }
+                catch (...)
+                {
+                    std::ostringstream msg;
+                    msg << msgPrefix(function) << "file " << i << ": posting attributes: unrecognized exception";
+                    LOGERROR(msg.str());
+                }
+            }
+
+            bool committed = true;
+            if (transaction && imgDB.commit() != 0)
+            {
+                LOGERROR(msgPrefix(function) + "committing the attributes failed");
+                committed = false;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                bool processed = posted[i] && committed;
+                if (analyzed[i] && !processed)
+                {
+                    addFailure();
+                }
+
+                if (!processed)
+                {
+                    status = TskModule::FAIL;
+                }
+
+                if (statuses != NULL)
+                {
+                    statuses[i] = processed ? TskModule::OK : TskModule::FAIL;
+                }
+            }
+
+            helpWithChunks(context);
+
+            return status;
+        }
+        catch (TskException &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix(function) << "TskException: " << ex.message();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
+        //catch (Poco::Exception &ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix(function) << "Poco::Exception: " << ex.displayText();
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}
+        catch (std::exception &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix(function) << "std::exception: " << ex.what();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
+        //catch (System::Exception ^ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix(function) << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}        
+        catch (...)
+        {
+            LOGERROR(msgPrefix(function) + "unrecognized exception");
+            return TskModule::FAIL;
+        }
+    }
+
+    /**
+    * Module execution function for post-processing modules. Logs where the
+    * module spent its time analyzing files since it was initialized: the
+    * throughput, the number of files handled each way, the time spent 
+    * reading, counting and reducing, and a histogram of the time taken per
+    * file.
+    *
+    * CAVEAT: This function is intended to be called by TSK Framework only. 
+    * Linux/OS-X modules should *not* call this function within the module 
+    * unless appropriate compiler/linker options are used to bind all 
+    * library-internal symbols at link time. 
+    *
+    * @returns TskModule::OK on success, TskModule::FAIL on error
+    */
+    TskModule::Status TSK_MODULE_EXPORT report()
+    {
+        // The TSK Framework convention is to prefix error messages with the
+        // name of the module/class and the function that emitted the message. 
+        std::ostringstream msgPrefix;
+        msgPrefix << MODULE_NAME << "::report : ";
+
+        // Well-behaved modules should catch and log all possible exceptions
+        // and return an appropriate TskModule::Status to the TSK Framework. 
+        try
+        {
+            EntropyModule::RunStatistics statistics;
+            if (threadContexts != NULL)
+            {
+                threadContexts->addStatisticsTo(statistics);
+            }
+
+            std::vector<std::string> lines = statistics.summary();
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                LOGINFO(msgPrefix.str() + lines[i]);
+            }
+
+            return TskModule::OK;
+        }
+        catch (TskException &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix.str() << "TskException: " << ex.message();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
+        //catch (Poco::Exception &ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix.str() << "Poco::Exception: " << ex.displayText();
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}
+        catch (std::exception &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix.str() << "std::exception: " << ex.what();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
+        //catch (System::Exception ^ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix.str() << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}        
+        catch (...)
+        {
+            LOGERROR(msgPrefix.str() + "unrecognized exception");
+            return TskModule::FAIL;
+        }
+    }
+
+    /**
+    * Module cleanup function. This is where the module should free any resources 
+    * allocated during initialization or execution.
+    *
+    * CAVEAT: This function is intended to be called by TSK Framework only. 
+    * Linux/OS-X modules should *not* call this function within the module 
+    * unless appropriate compiler/linker options are used to bind all 
+    * library-internal symbols at link time. 
+    *
+    * @returns TskModule::OK on success and TskModule::FAIL on error.
+    */
+    TskModule::Status TSK_MODULE_EXPORT finalize()
+    {
+        // The TSK Framework convention is to prefix error messages with the
+        // name of the module/class and the function that emitted the message. 
+        std::ostringstream msgPrefix;
+        msgPrefix << MODULE_NAME << "::finalize : ";
+
+        // Well-behaved modules should catch and log all possible exceptions
+        // and return an appropriate TskModule::Status to the TSK Framework. 
+        try
+        {
+            delete chunkScheduler;
+            chunkScheduler = NULL;
+
+            delete gpuCounter;
+            gpuCounter = NULL;
+
+            delete threadContexts;
+            threadContexts = NULL;
+
+            // Release the cache and the resume store even if saving them 
+            // fails.
+            std::auto_ptr<EntropyModule::ResultCache> cache(resultCache);
+            resultCache = NULL;
+            std::auto_ptr<EntropyModule::ResumeStore> store(resumeStore);
+            resumeStore = NULL;
+            if (cache.get() != NULL)
+            {
+                cache->save();
+            }
+
+            if (store.get() != NULL)
+            {
+                store->save();
+            }
+
+            return TskModule::OK;
+        }
+        catch (TskException &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix.str() << "TskException: " << ex.message();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and the #include of "Poco/Exception.h" if using Poco.
+        //catch (Poco::Exception &ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix.str() << "Poco::Exception: " << ex.displayText();
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}
+        catch (std::exception &ex)
+        {
+            std::ostringstream msg;
+            msg << msgPrefix.str() << "std::exception: " << ex.what();
+            LOGERROR(msg.str());
+            return TskModule::FAIL;
+        }
+        // Uncomment this catch block and add necessary .NET references if using C++/CLI.
+        //catch (System::Exception ^ex)
+        //{
+        //    std::ostringstream msg;
+        //    msg << msgPrefix.str() << "System::Exception: " << Maytag::systemStringToStdString(ex->Message);
+        //    LOGERROR(msg.str());
+        //    return TskModule::FAIL;
+        //}        
+        catch (...)
+        {
+            LOGERROR(msgPrefix.str() + "unrecognized exception");
+            return TskModule::FAIL;
+        }
+    }
 }
\ No newline at end of file
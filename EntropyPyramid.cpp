@@ -0,0 +1,238 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropyPyramid.cpp
+* Contains the implementation of a class that computes the entropy of a 
+* file's blocks at several block sizes and saves them as a pyramid file.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "EntropyPyramid.h"
+#include "EntropyMath.h"
+
+// Poco includes
+#include "Poco/AtomicCounter.h"
+#include "Poco/BinaryWriter.h"
+#include "Poco/File.h"
+#include "Poco/Process.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <assert.h>
+#include <fstream>
+#include <sstream>
+#include <string.h>
+
+namespace
+{
+    const char PYRAMID_MAGIC[] = "ENTPYRMD";
+    const Poco::UInt32 PYRAMID_VERSION = 1;
+
+    const double MAX_ENTROPY = 8.0;
+
+    // Numbers the temporary files of the pyramids this process saves.
+    Poco::AtomicCounter tempFileCount;
+
+    void writeBytes(Poco::BinaryWriter &writer, const std::vector<unsigned char> &bytes)
+    {
+        if (!bytes.empty())
+        {
+            writer.writeRaw(reinterpret_cast<const char*>(&bytes[0]), bytes.size());
+        }
+    }
+}
+
+namespace EntropyModule
+{
+    EntropyPyramid::EntropyPyramid(size_t blockSize, size_t levelCount)
+    {
+        reset(blockSize, levelCount);
+    }
+
+    void EntropyPyramid::reset(size_t blockSize, size_t levelCount)
+    {
+        assert(blockSize > 0 && levelCount > 0);
+        m_levels.resize(levelCount);
+        m_size = 0;
+        m_blockFill = 0;
+        uint64_t levelBlockSize = blockSize;
+        for (size_t i = 0; i < m_levels.size(); ++i)
+        {
+            Level &level = m_levels[i];
+            level.blockSize = levelBlockSize;
+            memset(level.counts, 0, sizeof(level.counts));
+            level.total = 0;
+            level.children = 0;
+            level.maximum = 0;
+            level.entropies.clear();
+            level.maxima.clear();
+            levelBlockSize *= FANOUT;
+        }
+    }
+
+    void EntropyPyramid::add(const uint8_t *data, size_t length)
+    {
+        Level &finest = m_levels[0];
+        while (length > 0)
+        {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(length, finest.blockSize - m_blockFill));
+            for (size_t i = 0; i < n; ++i)
+            {
+                ++finest.counts[data[i]];
+            }
+
+            finest.total += n;
+            m_blockFill += n;
+            m_size += n;
+            if (m_blockFill == finest.blockSize)
+            {
+                completeBlock(0);
+            }
+
+            data += n;
+            length -= n;
+        }
+    }
+
+    void EntropyPyramid::finish()
+    {
+        // Record the partly filled blocks at the end of the file, finest 
+        // first so that each is added to its parent.
+        if (m_blockFill > 0)
+        {
+            completeBlock(0);
+        }
+
+        for (size_t i = 1; i < m_levels.size(); ++i)
+        {
+            if (m_levels[i].children > 0)
+            {
+                completeBlock(i);
+            }
+        }
+    }
+
+    void EntropyPyramid::save(const std::string &path) const
+    {
+        // Write a new file and swap it in, so a reader never sees a partly
+        // written pyramid. Files with the same content share a pyramid, so
+        // several threads may save it at once; each writes a file of its 
+        // own.
+        std::ostringstream tempName;
+        tempName << path << "." << Poco::Process::id() << "-" << ++tempFileCount << ".tmp";
+        std::string tempPath = tempName.str();
+        try
+        {
+            std::ofstream stream(tempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!stream)
+            {
+                throw TskException("cannot create entropy pyramid " + tempPath);
+            }
+
+            Poco::BinaryWriter writer(stream, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+            writer.writeRaw(PYRAMID_MAGIC, sizeof(PYRAMID_MAGIC) - 1);
+            writer << PYRAMID_VERSION << static_cast<Poco::UInt64>(m_size) << static_cast<Poco::UInt32>(FANOUT) 
+                << static_cast<Poco::UInt32>(m_levels.size());
+            for (size_t i = 0; i < m_levels.size(); ++i)
+            {
+                const Level &level = m_levels[i];
+                writer << static_cast<Poco::UInt64>(level.blockSize) << static_cast<Poco::UInt64>(level.entropies.size());
+                writeBytes(writer, level.entropies);
+                writeBytes(writer, level.maxima);
+            }
+
+            writer.flush();
+            if (!stream)
+            {
+                throw TskException("cannot write entropy pyramid " + tempPath);
+            }
+
+            stream.close();
+            Poco::File(tempPath).renameTo(path);
+        }
+        catch (...)
+        {
+            try
+            {
+                Poco::File(tempPath).remove();
+            }
+            catch (...)
+            {
+            }
+
+            throw;
+        }
+    }
+
+    void EntropyPyramid::completeBlock(size_t level)
+    {
+        Level &current = m_levels[level];
+        double entropy = shannonEntropy(current.counts, current.total);
+        unsigned char scaled = static_cast<unsigned char>(std::min(entropy, MAX_ENTROPY) * 255.0 / MAX_ENTROPY + 0.5);
+        current.entropies.push_back(scaled);
+        if (level == 0)
+        {
+            current.maximum = scaled;
+            m_blockFill = 0;
+        }
+        else
+        {
+            // The finest blocks are their own maxima, so only coarser levels 
+            // store them.
+            current.maxima.push_back(current.maximum);
+        }
+
+        if (level + 1 < m_levels.size())
+        {
+            Level &parent = m_levels[level + 1];
+            for (int i = 0; i < 256; ++i)
+            {
+                parent.counts[i] += current.counts[i];
+            }
+
+            parent.total += current.total;
+            parent.maximum = parent.children > 0 ? std::max(parent.maximum, current.maximum) : current.maximum;
+            ++parent.children;
+            if (parent.children == FANOUT)
+            {
+                completeBlock(level + 1);
+            }
+        }
+
+        memset(current.counts, 0, sizeof(current.counts));
+        current.total = 0;
+        current.children = 0;
+        current.maximum = 0;
+    }
+}
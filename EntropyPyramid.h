@@ -0,0 +1,127 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropyPyramid.h
+* Contains the interface of a class that computes the entropy of a file's 
+* blocks at several block sizes and saves them as a pyramid file.
+*/
+
+#ifndef _ENTROPY_ENTROPYPYRAMID_H
+#define _ENTROPY_ENTROPYPYRAMID_H
+
+// Module includes
+#include "ContentAnalyzer.h"
+
+// C/C++ library includes
+#include <string>
+#include <vector>
+
+namespace EntropyModule
+{
+    /**
+    * Computes the entropy of consecutive blocks of a file at several levels,
+    * each level's blocks FANOUT times the size of the level below. Only the
+    * finest blocks are counted from the content; each coarser block's 
+    * counts are the sum of its children's, so the content is read once 
+    * and only one array of counts per level is held. The blocks are small,
+    * so the counts are kept in plain arrays rather than ByteHistograms, 
+    * whose banks would cost more to clear and flush than the counting.
+    *
+    * Every block also records the highest entropy of the finest blocks it 
+    * covers, so a reader of the saved pyramid can find the regions above 
+    * an entropy by descending only into blocks whose maximum reaches it. 
+    * Entropies are scaled from 0-8 bits to 0-255, costing one byte per 
+    * finest block, or two per coarser block.
+    */
+    class EntropyPyramid : public ContentAnalyzer
+    {
+    public:
+        /**
+        * The number of blocks of one level that make up a block of the 
+        * level above.
+        */
+        enum { FANOUT = 16 };
+
+        /**
+        * @param blockSize The size of the finest blocks in bytes.
+        * @param levelCount The number of levels, at least 1.
+        */
+        EntropyPyramid(size_t blockSize, size_t levelCount);
+
+        /**
+        * Prepares the pyramid for a new file, with new settings, keeping 
+        * its memory. Takes the same parameters as the constructor.
+        */
+        void reset(size_t blockSize, size_t levelCount);
+
+        virtual void add(const uint8_t *data, size_t length);
+        virtual void finish();
+
+        /**
+        * @return The number of bytes the pyramid covers.
+        */
+        uint64_t size() const { return m_size; }
+
+        /**
+        * Saves the pyramid, replacing the content of the file. The pyramid
+        * is written to a temporary file of its own in the same directory 
+        * and renamed, so writers of the same pyramid on several threads or
+        * processes do not interfere and a reader never sees a partly 
+        * written file.
+        *
+        * @param path The path of the file.
+        * @throws TskException if the file cannot be written.
+        */
+        void save(const std::string &path) const;
+
+    private:
+        struct Level
+        {
+            uint64_t blockSize;
+            uint64_t counts[256];
+            uint64_t total;
+            uint64_t children;
+            unsigned char maximum;
+            std::vector<unsigned char> entropies;
+            std::vector<unsigned char> maxima;
+        };
+
+        // Records the current block of a level and adds it to the level 
+        // above.
+        void completeBlock(size_t level);
+
+        std::vector<Level> m_levels;
+        uint64_t m_size;
+        uint64_t m_blockFill;
+    };
+}
+
+#endif
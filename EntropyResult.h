@@ -0,0 +1,93 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropyResult.h
+* Contains the definition of the results the module computes for a file.
+*/
+
+#ifndef _ENTROPY_ENTROPYRESULT_H
+#define _ENTROPY_ENTROPYRESULT_H
+
+// C/C++ library includes
+#include <stdint.h>
+
+namespace EntropyModule
+{
+    /**
+    * The whole-file results the module posts for a file.
+    */
+    struct EntropyResult
+    {
+        EntropyResult() :
+            entropy(0.0),
+            sampled(false),
+            sampleCoverage(1.0),
+            sampleIntervalWidth(0.0),
+            partial(false),
+            bytesCounted(0)
+        {
+        }
+
+        /**
+        * The Shannon entropy of the file in bits per byte, or an estimate of 
+        * it if the file was sampled.
+        */
+        double entropy;
+
+        /**
+        * Whether the entropy was estimated from a sample of the file.
+        */
+        bool sampled;
+
+        /**
+        * The fraction of the file's bytes the estimate is based on.
+        */
+        double sampleCoverage;
+
+        /**
+        * The width of the confidence interval of the estimate, in bits.
+        */
+        double sampleIntervalWidth;
+
+        /**
+        * Whether reading the file stopped at its byte or time budget, so the
+        * results cover only the start of it.
+        */
+        bool partial;
+
+        /**
+        * The number of bytes the results of a partial file are based on.
+        */
+        uint64_t bytesCounted;
+    };
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropySampler.cpp
+* Contains the implementation of a class that estimates the entropy of a 
+* file from a sample of its blocks.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "EntropySampler.h"
+#include "AlignedBuffer.h"
+#include "ByteHistogram.h"
+#include "EntropyMath.h"
+#include "EntropyResult.h"
+#include "PositionalReader.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+    // The z-score of a two-sided 95% confidence interval.
+    const double Z_95 = 1.96;
+
+    /**
+    * Reverses the order of the lowest bits of a number.
+    */
+    uint64_t reverseBits(uint64_t value, int bitCount)
+    {
+        uint64_t reversed = 0;
+        for (int i = 0; i < bitCount; ++i)
+        {
+            reversed = (reversed << 1) | (value & 1);
+            value >>= 1;
+        }
+
+        return reversed;
+    }
+}
+
+namespace EntropyModule
+{
+    EntropySampler::EntropySampler(size_t blockSize, double epsilon, uint64_t minBlocks) :
+        m_groupCounts(GROUP_COUNT * 256)
+    {
+        reset(blockSize, epsilon, minBlocks);
+    }
+
+    void EntropySampler::reset(size_t blockSize, double epsilon, uint64_t minBlocks)
+    {
+        m_blockSize = blockSize;
+        m_epsilon = epsilon;
+        m_minBlocks = std::max<uint64_t>(minBlocks, 2);
+    }
+
+    void EntropySampler::estimate(PositionalReader &reader, uint64_t size, AlignedBuffer &buffer, ByteHistogram &histogram, EntropyResult &result)
+    {
+        uint64_t blockCount = (size + m_blockSize - 1) / m_blockSize;
+        int bitCount = 0;
+        while ((1ULL << bitCount) < blockCount)
+        {
+            ++bitCount;
+        }
+
+        buffer.resize(m_blockSize);
+        std::fill(m_groupCounts.begin(), m_groupCounts.end(), 0);
+        memset(m_groupTotals, 0, sizeof(m_groupTotals));
+        ByteHistogram blockHistogram;
+        uint64_t blocksRead = 0;
+        uint64_t bytesRead = 0;
+        double width = 0.0;
+        bool stoppedEarly = false;
+
+        // Indices past the last block are skipped, which leaves the order of
+        // the rest spread evenly.
+        uint64_t slotCount = 1ULL << bitCount;
+        for (uint64_t slot = 0; slot < slotCount; ++slot)
+        {
+            uint64_t block = reverseBits(slot, bitCount);
+            if (block >= blockCount)
+            {
+                continue;
+            }
+
+            uint64_t offset = block * m_blockSize;
+            size_t length = static_cast<size_t>(std::min<uint64_t>(m_blockSize, size - offset));
+            size_t blockBytes = reader.readAt(offset, buffer.data(), length);
+            if (blockBytes == 0)
+            {
+                // Past the end of a file that is shorter than its reported size.
+                continue;
+            }
+
+            blockHistogram.clear();
+            blockHistogram.add(reinterpret_cast<const uint8_t*>(buffer.data()), blockBytes);
+            histogram.merge(blockHistogram);
+            bytesRead += blockBytes;
+
+            const uint64_t *blockCounts = blockHistogram.counts();
+            size_t group = static_cast<size_t>(blocksRead % GROUP_COUNT);
+            uint64_t *groupCounts = &m_groupCounts[group * 256];
+            for (int i = 0; i < 256; ++i)
+            {
+                groupCounts[i] += blockCounts[i];
+            }
+
+            m_groupTotals[group] += blockBytes;
+            ++blocksRead;
+
+            if (blocksRead >= m_minBlocks)
+            {
+                double sampledFraction = static_cast<double>(blocksRead) / static_cast<double>(blockCount);
+                width = intervalWidth(std::min<uint64_t>(blocksRead, GROUP_COUNT), sampledFraction);
+                if (width <= m_epsilon)
+                {
+                    stoppedEarly = blocksRead < blockCount;
+                    break;
+                }
+            }
+        }
+
+        result.entropy = shannonEntropy(histogram.counts(), histogram.total());
+        result.sampled = stoppedEarly;
+        result.sampleCoverage = size > 0 ? static_cast<double>(bytesRead) / static_cast<double>(size) : 1.0;
+        result.sampleIntervalWidth = result.sampled ? width : 0.0;
+    }
+
+    double EntropySampler::intervalWidth(uint64_t groupCount, double sampledFraction) const
+    {
+        uint64_t counts[256] = { 0 };
+        uint64_t total = 0;
+        for (uint64_t group = 0; group < groupCount; ++group)
+        {
+            const uint64_t *groupCounts = &m_groupCounts[static_cast<size_t>(group) * 256];
+            for (int i = 0; i < 256; ++i)
+            {
+                counts[i] += groupCounts[i];
+            }
+
+            total += m_groupTotals[group];
+        }
+
+        // The entropy with each group left out in turn, and their mean.
+        double entropy = shannonEntropy(counts, total);
+        double leftOut[GROUP_COUNT];
+        double mean = 0.0;
+        for (uint64_t group = 0; group < groupCount; ++group)
+        {
+            const uint64_t *groupCounts = &m_groupCounts[static_cast<size_t>(group) * 256];
+            uint64_t rest[256];
+            for (int i = 0; i < 256; ++i)
+            {
+                rest[i] = counts[i] - groupCounts[i];
+            }
+
+            leftOut[group] = shannonEntropy(rest, total - m_groupTotals[group]);
+            mean += leftOut[group];
+        }
+
+        double g = static_cast<double>(groupCount);
+        mean /= g;
+        double sumOfSquares = 0.0;
+        for (uint64_t group = 0; group < groupCount; ++group)
+        {
+            sumOfSquares += (leftOut[group] - mean) * (leftOut[group] - mean);
+        }
+
+        double standardDeviation = sqrt((g - 1.0) / g * sumOfSquares);
+        double bias = (g - 1.0) * (mean - entropy);
+        // The bias is not scaled down for the fraction read: blocks that 
+        // miss byte values can leave the estimate as far off near the end 
+        // of the file as at the start.
+        double unsampled = std::max(0.0, 1.0 - sampledFraction);
+        return 2.0 * (Z_95 * standardDeviation * sqrt(unsampled) + fabs(bias));
+    }
+}
@@ -0,0 +1,124 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropySampler.h
+* Contains the interface of a class that estimates the entropy of a file from
+* a sample of its blocks.
+*/
+
+#ifndef _ENTROPY_ENTROPYSAMPLER_H
+#define _ENTROPY_ENTROPYSAMPLER_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace EntropyModule
+{
+    class AlignedBuffer;
+    class ByteHistogram;
+    class PositionalReader;
+    struct EntropyResult;
+
+    /**
+    * Estimates the entropy of a file by reading blocks spread across it
+    * until the estimate is good enough.
+    *
+    * Blocks are visited in bit-reversed index order, so however early 
+    * sampling stops, the blocks read are spread evenly over the file. The 
+    * estimate is the entropy of the combined histogram of the blocks read. 
+    * Its uncertainty is judged with a delete-a-group jackknife: the blocks 
+    * read are dealt in turn into GROUP_COUNT groups, and the estimate is 
+    * recomputed with each group left out. With g groups, m of M blocks 
+    * read, a jackknife standard deviation s and a jackknife bias b, the 
+    * 95% confidence interval of the estimate is taken to be 
+    * 2 * (1.96 * s * sqrt(1 - m / M) + |b|) bits wide. The bias term 
+    * widens the interval when the blocks read miss byte values the rest 
+    * of the file may hold, which the spread alone cannot show.
+    * Sampling stops once at least the minimum number of blocks has been 
+    * read and that width is at most epsilon. A file with uniform content,
+    * such as encrypted data, therefore stops after the minimum number of 
+    * blocks, while a file whose content varies is read more thoroughly, up
+    * to all of it.
+    */
+    class EntropySampler
+    {
+    public:
+        /**
+        * The number of jackknife groups.
+        */
+        enum { GROUP_COUNT = 32 };
+
+        /**
+        * @param blockSize The size of a sampled block in bytes.
+        * @param epsilon The confidence interval width, in bits, at which 
+        * sampling stops.
+        * @param minBlocks The minimum number of blocks to read.
+        */
+        EntropySampler(size_t blockSize, double epsilon, uint64_t minBlocks);
+
+        /**
+        * Prepares the sampler for new settings, keeping its memory. Takes
+        * the same parameters as the constructor.
+        */
+        void reset(size_t blockSize, double epsilon, uint64_t minBlocks);
+
+        /**
+        * Estimates the entropy of a file.
+        *
+        * @param reader Reads the file's content.
+        * @param size The size of the file in bytes.
+        * @param buffer A buffer for the blocks read, resized to the block
+        * size.
+        * @param histogram Receives the counts of the bytes read.
+        * @param result Receives the estimate. If every block ended up being
+        * read, it is the exact entropy and is not marked as sampled.
+        * @throws TskException if reading the file failed.
+        */
+        void estimate(PositionalReader &reader, uint64_t size, AlignedBuffer &buffer, ByteHistogram &histogram, EntropyResult &result);
+
+    private:
+        // Returns the width of the confidence interval of the entropy of 
+        // the groups' combined counts.
+        double intervalWidth(uint64_t groupCount, double sampledFraction) const;
+
+        size_t m_blockSize;
+        double m_epsilon;
+        uint64_t m_minBlocks;
+
+        // The counts of each group's blocks, GROUP_COUNT rows of 256.
+        std::vector<uint64_t> m_groupCounts;
+        uint64_t m_groupTotals[GROUP_COUNT];
+    };
+}
+
+#endif
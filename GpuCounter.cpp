@@ -0,0 +1,535 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file GpuCounter.cpp
+* Contains the implementation of a class that counts the bytes of large 
+* files on an OpenCL device.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "GpuCounter.h"
+#include "ByteHistogram.h"
+#include "PositionalReader.h"
+
+#ifdef ENTROPY_OPENCL
+
+// Poco includes
+#include "Poco/Exception.h"
+#include "Poco/SharedLibrary.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+namespace
+{
+    // The size of the pinned buffers content is streamed through, and the
+    // number of them, so that one is read while the device counts another.
+    const size_t BUFFER_SIZE = 16 * 1024 * 1024;
+    const size_t SLOT_COUNT = 2;
+
+    // Every work-item of a group of 256 owns the local bin of its index.
+    const size_t GROUP_SIZE = 256;
+    const size_t GROUP_COUNT = 64;
+
+    const char KERNEL_SOURCE[] =
+        "__kernel void countBytes(__global const uchar *data, uint length, __global uint *groupBins)\n"
+        "{\n"
+        "    __local uint bins[256];\n"
+        "    uint bin = get_local_id(0);\n"
+        "    bins[bin] = 0;\n"
+        "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+        "    for (uint i = get_global_id(0); i < length; i += get_global_size(0))\n"
+        "    {\n"
+        "        atomic_inc(&bins[data[i]]);\n"
+        "    }\n"
+        "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+        "    groupBins[get_group_id(0) * 256 + bin] = bins[bin];\n"
+        "}\n";
+
+    const char *LIBRARY_NAMES[] =
+    {
+#if defined(_WIN32)
+        "OpenCL.dll",
+#elif defined(__APPLE__)
+        "/System/Library/Frameworks/OpenCL.framework/OpenCL",
+#else
+        "libOpenCL.so.1",
+        "libOpenCL.so",
+#endif
+        NULL
+    };
+
+    typedef cl_int (CL_API_CALL *GetPlatformIDs)(cl_uint, cl_platform_id*, cl_uint*);
+    typedef cl_int (CL_API_CALL *GetDeviceIDs)(cl_platform_id, cl_device_type, cl_uint, cl_device_id*, cl_uint*);
+    typedef cl_context (CL_API_CALL *CreateContext)(const cl_context_properties*, cl_uint, const cl_device_id*, 
+        void (CL_API_CALL*)(const char*, const void*, size_t, void*), void*, cl_int*);
+    typedef cl_command_queue (CL_API_CALL *CreateCommandQueue)(cl_context, cl_device_id, cl_command_queue_properties, cl_int*);
+    typedef cl_program (CL_API_CALL *CreateProgramWithSource)(cl_context, cl_uint, const char**, const size_t*, cl_int*);
+    typedef cl_int (CL_API_CALL *BuildProgram)(cl_program, cl_uint, const cl_device_id*, const char*, 
+        void (CL_API_CALL*)(cl_program, void*), void*);
+    typedef cl_kernel (CL_API_CALL *CreateKernel)(cl_program, const char*, cl_int*);
+    typedef cl_mem (CL_API_CALL *CreateBuffer)(cl_context, cl_mem_flags, size_t, void*, cl_int*);
+    typedef void *(CL_API_CALL *EnqueueMapBuffer)(cl_command_queue, cl_mem, cl_bool, cl_map_flags, size_t, size_t, 
+        cl_uint, const cl_event*, cl_event*, cl_int*);
+    typedef cl_int (CL_API_CALL *EnqueueUnmapMemObject)(cl_command_queue, cl_mem, void*, cl_uint, const cl_event*, cl_event*);
+    typedef cl_int (CL_API_CALL *EnqueueWriteBuffer)(cl_command_queue, cl_mem, cl_bool, size_t, size_t, const void*, 
+        cl_uint, const cl_event*, cl_event*);
+    typedef cl_int (CL_API_CALL *EnqueueReadBuffer)(cl_command_queue, cl_mem, cl_bool, size_t, size_t, void*, 
+        cl_uint, const cl_event*, cl_event*);
+    typedef cl_int (CL_API_CALL *SetKernelArg)(cl_kernel, cl_uint, size_t, const void*);
+    typedef cl_int (CL_API_CALL *EnqueueNDRangeKernel)(cl_command_queue, cl_kernel, cl_uint, const size_t*, const size_t*, 
+        const size_t*, cl_uint, const cl_event*, cl_event*);
+    typedef cl_int (CL_API_CALL *Flush)(cl_command_queue);
+    typedef cl_int (CL_API_CALL *Finish)(cl_command_queue);
+    typedef cl_int (CL_API_CALL *WaitForEvents)(cl_uint, const cl_event*);
+    typedef cl_int (CL_API_CALL *ReleaseEvent)(cl_event);
+    typedef cl_int (CL_API_CALL *ReleaseMemObject)(cl_mem);
+    typedef cl_int (CL_API_CALL *ReleaseKernel)(cl_kernel);
+    typedef cl_int (CL_API_CALL *ReleaseProgram)(cl_program);
+    typedef cl_int (CL_API_CALL *ReleaseCommandQueue)(cl_command_queue);
+    typedef cl_int (CL_API_CALL *ReleaseContext)(cl_context);
+
+    /**
+    * Thrown when an OpenCL call fails.
+    */
+    struct OpenClError
+    {
+        OpenClError(const char *failedCall, cl_int result) : 
+            call(failedCall),
+            error(result)
+        {
+        }
+
+        const char *call;
+        cl_int error;
+    };
+
+    void check(cl_int error, const char *call)
+    {
+        if (error != CL_SUCCESS)
+        {
+            throw OpenClError(call, error);
+        }
+    }
+
+    template <typename Function>
+    void loadFunction(Poco::SharedLibrary &library, const char *name, Function &function)
+    {
+        function = reinterpret_cast<Function>(library.getSymbol(name));
+    }
+}
+
+namespace EntropyModule
+{
+    /**
+    * The OpenCL functions and the objects created with them.
+    */
+    struct GpuCounter::Device
+    {
+        Device() :
+            context(NULL),
+            queue(NULL),
+            program(NULL),
+            kernel(NULL),
+            groupBins(SLOT_COUNT * GROUP_COUNT * 256)
+        {
+            for (size_t slot = 0; slot < SLOT_COUNT; ++slot)
+            {
+                pinned[slot] = NULL;
+                host[slot] = NULL;
+                data[slot] = NULL;
+                bins[slot] = NULL;
+            }
+        }
+
+        ~Device()
+        {
+            if (queue != NULL)
+            {
+                finish(queue);
+            }
+
+            for (size_t slot = 0; slot < SLOT_COUNT; ++slot)
+            {
+                if (host[slot] != NULL)
+                {
+                    enqueueUnmapMemObject(queue, pinned[slot], host[slot], 0, NULL, NULL);
+                }
+
+                if (pinned[slot] != NULL) releaseMemObject(pinned[slot]);
+                if (data[slot] != NULL) releaseMemObject(data[slot]);
+                if (bins[slot] != NULL) releaseMemObject(bins[slot]);
+            }
+
+            if (queue != NULL)
+            {
+                finish(queue);
+                releaseCommandQueue(queue);
+            }
+
+            if (kernel != NULL) releaseKernel(kernel);
+            if (program != NULL) releaseProgram(program);
+            if (context != NULL) releaseContext(context);
+        }
+
+        void load()
+        {
+            // A library that cannot be loaded is reported like a missing 
+            // device.
+            for (const char **name = LIBRARY_NAMES; *name != NULL && !library.isLoaded(); ++name)
+            {
+                try
+                {
+                    library.load(*name);
+                }
+                catch (Poco::LibraryLoadException &)
+                {
+                }
+            }
+
+            if (!library.isLoaded())
+            {
+                throw TskException("the OpenCL library cannot be loaded");
+            }
+
+            try
+            {
+                loadFunction(library, "clGetPlatformIDs", getPlatformIDs);
+                loadFunction(library, "clGetDeviceIDs", getDeviceIDs);
+                loadFunction(library, "clCreateContext", createContext);
+                loadFunction(library, "clCreateCommandQueue", createCommandQueue);
+                loadFunction(library, "clCreateProgramWithSource", createProgramWithSource);
+                loadFunction(library, "clBuildProgram", buildProgram);
+                loadFunction(library, "clCreateKernel", createKernel);
+                loadFunction(library, "clCreateBuffer", createBuffer);
+                loadFunction(library, "clEnqueueMapBuffer", enqueueMapBuffer);
+                loadFunction(library, "clEnqueueUnmapMemObject", enqueueUnmapMemObject);
+                loadFunction(library, "clEnqueueWriteBuffer", enqueueWriteBuffer);
+                loadFunction(library, "clEnqueueReadBuffer", enqueueReadBuffer);
+                loadFunction(library, "clSetKernelArg", setKernelArg);
+                loadFunction(library, "clEnqueueNDRangeKernel", enqueueNDRangeKernel);
+                loadFunction(library, "clFlush", flush);
+                loadFunction(library, "clFinish", finish);
+                loadFunction(library, "clWaitForEvents", waitForEvents);
+                loadFunction(library, "clReleaseEvent", releaseEvent);
+                loadFunction(library, "clReleaseMemObject", releaseMemObject);
+                loadFunction(library, "clReleaseKernel", releaseKernel);
+                loadFunction(library, "clReleaseProgram", releaseProgram);
+                loadFunction(library, "clReleaseCommandQueue", releaseCommandQueue);
+                loadFunction(library, "clReleaseContext", releaseContext);
+            }
+            catch (Poco::NotFoundException &)
+            {
+                throw TskException("the OpenCL library lacks OpenCL 1.1 functions");
+            }
+        }
+
+        void open()
+        {
+            cl_uint platformCount = 0;
+            if (getPlatformIDs(0, NULL, &platformCount) != CL_SUCCESS || platformCount == 0)
+            {
+                throw TskException("no OpenCL platform is installed");
+            }
+
+            std::vector<cl_platform_id> platforms(platformCount);
+            check(getPlatformIDs(platformCount, &platforms[0], NULL), "clGetPlatformIDs");
+
+            cl_device_id device = NULL;
+            for (cl_uint i = 0; i < platformCount && device == NULL; ++i)
+            {
+                cl_uint deviceCount = 0;
+                if (getDeviceIDs(platforms[i], CL_DEVICE_TYPE_GPU, 1, &device, &deviceCount) != CL_SUCCESS || deviceCount == 0)
+                {
+                    device = NULL;
+                }
+            }
+
+            if (device == NULL)
+            {
+                throw TskException("no OpenCL GPU is present");
+            }
+
+            cl_int error = CL_SUCCESS;
+            context = createContext(NULL, 1, &device, NULL, NULL, &error);
+            check(error, "clCreateContext");
+            queue = createCommandQueue(context, device, 0, &error);
+            check(error, "clCreateCommandQueue");
+
+            const char *source = KERNEL_SOURCE;
+            program = createProgramWithSource(context, 1, &source, NULL, &error);
+            check(error, "clCreateProgramWithSource");
+            check(buildProgram(program, 1, &device, "", NULL, NULL), "clBuildProgram");
+            kernel = createKernel(program, "countBytes", &error);
+            check(error, "clCreateKernel");
+
+            // Reading into memory allocated by the driver and kept mapped 
+            // lets the driver copy it to the device without staging it.
+            for (size_t slot = 0; slot < SLOT_COUNT; ++slot)
+            {
+                pinned[slot] = createBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, BUFFER_SIZE, NULL, &error);
+                check(error, "clCreateBuffer");
+                host[slot] = static_cast<char*>(enqueueMapBuffer(queue, pinned[slot], CL_TRUE, CL_MAP_WRITE, 0, BUFFER_SIZE, 0, NULL, NULL, &error));
+                check(error, "clEnqueueMapBuffer");
+                data[slot] = createBuffer(context, CL_MEM_READ_ONLY, BUFFER_SIZE, NULL, &error);
+                check(error, "clCreateBuffer");
+                bins[slot] = createBuffer(context, CL_MEM_WRITE_ONLY, GROUP_COUNT * 256 * sizeof(cl_uint), NULL, &error);
+                check(error, "clCreateBuffer");
+            }
+        }
+
+        /**
+        * Starts counting the length bytes in the host buffer of a slot. 
+        * The slot's event is signalled when its bins have been read back.
+        */
+        void start(size_t slot, size_t length)
+        {
+            cl_uint deviceLength = static_cast<cl_uint>(length);
+            check(enqueueWriteBuffer(queue, data[slot], CL_FALSE, 0, length, host[slot], 0, NULL, NULL), "clEnqueueWriteBuffer");
+            check(setKernelArg(kernel, 0, sizeof(cl_mem), &data[slot]), "clSetKernelArg");
+            check(setKernelArg(kernel, 1, sizeof(cl_uint), &deviceLength), "clSetKernelArg");
+            check(setKernelArg(kernel, 2, sizeof(cl_mem), &bins[slot]), "clSetKernelArg");
+
+            size_t globalSize = GROUP_COUNT * GROUP_SIZE;
+            size_t localSize = GROUP_SIZE;
+            check(enqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, NULL), "clEnqueueNDRangeKernel");
+            check(enqueueReadBuffer(queue, bins[slot], CL_FALSE, 0, GROUP_COUNT * 256 * sizeof(cl_uint), 
+                &groupBins[slot * GROUP_COUNT * 256], 0, NULL, &done[slot]), "clEnqueueReadBuffer");
+            check(flush(queue), "clFlush");
+        }
+
+        /**
+        * Waits for a slot to be counted and adds its bins to a histogram.
+        */
+        void collect(size_t slot, ByteHistogram &histogram)
+        {
+            cl_int error = waitForEvents(1, &done[slot]);
+            releaseEvent(done[slot]);
+            check(error, "clWaitForEvents");
+
+            const cl_uint *slotBins = &groupBins[slot * GROUP_COUNT * 256];
+            for (int value = 0; value < 256; ++value)
+            {
+                uint64_t count = 0;
+                for (size_t group = 0; group < GROUP_COUNT; ++group)
+                {
+                    count += slotBins[group * 256 + value];
+                }
+
+                histogram.addRun(static_cast<uint8_t>(value), count);
+            }
+        }
+
+        /**
+        * Waits for the device to finish with the slots still pending after
+        * a failure, so their buffers can be reused.
+        */
+        void abandon(bool *pending)
+        {
+            finish(queue);
+            for (size_t slot = 0; slot < SLOT_COUNT; ++slot)
+            {
+                if (pending[slot])
+                {
+                    releaseEvent(done[slot]);
+                    pending[slot] = false;
+                }
+            }
+        }
+
+        Poco::SharedLibrary library;
+        GetPlatformIDs getPlatformIDs;
+        GetDeviceIDs getDeviceIDs;
+        CreateContext createContext;
+        CreateCommandQueue createCommandQueue;
+        CreateProgramWithSource createProgramWithSource;
+        BuildProgram buildProgram;
+        CreateKernel createKernel;
+        CreateBuffer createBuffer;
+        EnqueueMapBuffer enqueueMapBuffer;
+        EnqueueUnmapMemObject enqueueUnmapMemObject;
+        EnqueueWriteBuffer enqueueWriteBuffer;
+        EnqueueReadBuffer enqueueReadBuffer;
+        SetKernelArg setKernelArg;
+        EnqueueNDRangeKernel enqueueNDRangeKernel;
+        Flush flush;
+        Finish finish;
+        WaitForEvents waitForEvents;
+        ReleaseEvent releaseEvent;
+        ReleaseMemObject releaseMemObject;
+        ReleaseKernel releaseKernel;
+        ReleaseProgram releaseProgram;
+        ReleaseCommandQueue releaseCommandQueue;
+        ReleaseContext releaseContext;
+
+        cl_context context;
+        cl_command_queue queue;
+        cl_program program;
+        cl_kernel kernel;
+        cl_mem pinned[SLOT_COUNT];
+        char *host[SLOT_COUNT];
+        cl_mem data[SLOT_COUNT];
+        cl_mem bins[SLOT_COUNT];
+        cl_event done[SLOT_COUNT];
+        std::vector<cl_uint> groupBins;
+    };
+
+    GpuCounter *GpuCounter::create(std::string &message)
+    {
+        std::auto_ptr<Device> device(new Device());
+        try
+        {
+            device->load();
+            device->open();
+        }
+        catch (TskException &ex)
+        {
+            message = ex.message();
+            return NULL;
+        }
+        catch (OpenClError &ex)
+        {
+            std::ostringstream msg;
+            msg << ex.call << " failed with error " << ex.error;
+            message = msg.str();
+            return NULL;
+        }
+
+        return new GpuCounter(device.release());
+    }
+
+    bool GpuCounter::count(PositionalReader &reader, uint64_t size, ByteHistogram &histogram)
+    {
+        if (!m_mutex.tryLock())
+        {
+            return false;
+        }
+
+        histogram.clear();
+        bool pending[SLOT_COUNT] = { false };
+        bool counted = true;
+        try
+        {
+            size_t slot = 0;
+            for (uint64_t offset = 0; offset < size; slot = (slot + 1) % SLOT_COUNT)
+            {
+                // The slot's buffer is free once its last content has been
+                // counted.
+                if (pending[slot])
+                {
+                    pending[slot] = false;
+                    m_pDevice->collect(slot, histogram);
+                }
+
+                size_t length = static_cast<size_t>(std::min<uint64_t>(BUFFER_SIZE, size - offset));
+                size_t bytesRead = reader.readAt(offset, m_pDevice->host[slot], length);
+                if (bytesRead == 0)
+                {
+                    break;
+                }
+
+                m_pDevice->start(slot, bytesRead);
+                pending[slot] = true;
+                offset += bytesRead;
+            }
+
+            for (slot = 0; slot < SLOT_COUNT; ++slot)
+            {
+                if (pending[slot])
+                {
+                    pending[slot] = false;
+                    m_pDevice->collect(slot, histogram);
+                }
+            }
+        }
+        catch (OpenClError &)
+        {
+            m_pDevice->abandon(pending);
+            counted = false;
+        }
+        catch (...)
+        {
+            m_pDevice->abandon(pending);
+            m_mutex.unlock();
+            throw;
+        }
+
+        m_mutex.unlock();
+        return counted;
+    }
+}
+
+#else
+
+namespace EntropyModule
+{
+    struct GpuCounter::Device
+    {
+    };
+
+    GpuCounter *GpuCounter::create(std::string &message)
+    {
+        message = "the module was built without OpenCL support";
+        return NULL;
+    }
+
+    bool GpuCounter::count(PositionalReader &, uint64_t, ByteHistogram &)
+    {
+        return false;
+    }
+}
+
+#endif
+
+namespace EntropyModule
+{
+    GpuCounter::GpuCounter(Device *pDevice) :
+        m_pDevice(pDevice)
+    {
+    }
+
+    GpuCounter::~GpuCounter()
+    {
+        delete m_pDevice;
+    }
+}
@@ -0,0 +1,107 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file GpuCounter.h
+* Contains the interface of a class that counts the bytes of large files on
+* an OpenCL device.
+*/
+
+#ifndef _ENTROPY_GPUCOUNTER_H
+#define _ENTROPY_GPUCOUNTER_H
+
+// Poco includes
+#include "Poco/Mutex.h"
+
+// C/C++ library includes
+#include <stdint.h>
+#include <string>
+
+namespace EntropyModule
+{
+    class ByteHistogram;
+    class PositionalReader;
+
+    /**
+    * Counts the bytes of files on an OpenCL GPU. Content is read into 
+    * pinned host buffers and streamed to the device, where each work-group
+    * counts into its own bins in local memory. The next buffer is read 
+    * while the device counts the previous one, and the bins of each buffer
+    * are added to the 64-bit totals of the histogram.
+    *
+    * Support is compiled in when ENTROPY_OPENCL is defined, which needs the
+    * OpenCL headers. The OpenCL library itself is loaded when a counter is 
+    * created, so the module also loads on machines without it. The device 
+    * counts one file at a time; a file that arrives while it is busy is 
+    * left to the caller to count.
+    */
+    class GpuCounter
+    {
+    public:
+        /**
+        * Creates a counter for the first GPU found.
+        *
+        * @param message Receives why no counter could be created.
+        * @return The counter, or NULL if OpenCL support was not compiled 
+        * in, the OpenCL library cannot be loaded or there is no GPU.
+        */
+        static GpuCounter *create(std::string &message);
+
+        ~GpuCounter();
+
+        /**
+        * Counts the bytes of a file, unless the device is busy with another
+        * file.
+        *
+        * @param reader Reads the file.
+        * @param size The size of the file in bytes.
+        * @param histogram Receives the counts. Cleared first, and left in an
+        * unspecified state if the file was not counted.
+        * @return False if the file was not counted because the device is 
+        * busy or an OpenCL call failed.
+        * @throws TskException if the file cannot be read.
+        */
+        bool count(PositionalReader &reader, uint64_t size, ByteHistogram &histogram);
+
+    private:
+        struct Device;
+
+        explicit GpuCounter(Device *pDevice);
+
+        // Not copyable.
+        GpuCounter(const GpuCounter&);
+        GpuCounter &operator=(const GpuCounter&);
+
+        Device *m_pDevice;
+        Poco::FastMutex m_mutex;
+    };
+}
+
+#endif
@@ -0,0 +1,58 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file HistogramEncoding.cpp
+* Contains the implementation of the function that encodes a byte histogram
+* as the bytes of a blackboard attribute.
+*/
+
+// Module includes
+#include "HistogramEncoding.h"
+
+namespace EntropyModule
+{
+    void encodeHistogram(const uint64_t *counts, std::vector<unsigned char> &encoded)
+    {
+        encoded.clear();
+        encoded.push_back(HISTOGRAM_ENCODING_VERSION);
+        for (int value = 0; value < 256; ++value)
+        {
+            uint64_t count = counts[value];
+            while (count >= 0x80)
+            {
+                encoded.push_back(static_cast<unsigned char>(count | 0x80));
+                count >>= 7;
+            }
+
+            encoded.push_back(static_cast<unsigned char>(count));
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file HistogramEncoding.h
+* Contains the functions that encode a byte histogram as the bytes of a 
+* blackboard attribute and decode it again. Other modules can include this
+* header to read the histograms the module posts; the decoder is defined
+* here so that they need not link with the module.
+*/
+
+#ifndef _ENTROPY_HISTOGRAMENCODING_H
+#define _ENTROPY_HISTOGRAMENCODING_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace EntropyModule
+{
+    /**
+    * The version of the encoding, stored in the first byte.
+    */
+    const unsigned char HISTOGRAM_ENCODING_VERSION = 1;
+
+    /**
+    * Encodes the 256 counts of a byte histogram. The encoding is a version 
+    * byte followed by each count in byte value order as an unsigned LEB128
+    * varint: seven bits per byte, least significant first, with the high 
+    * bit set on every byte but the last. An empty bin takes one byte, so a
+    * histogram takes between 257 and 2561 bytes.
+    *
+    * @param counts The 256 counts.
+    * @param encoded Receives the encoding, replacing its content.
+    */
+    void encodeHistogram(const uint64_t *counts, std::vector<unsigned char> &encoded);
+
+    /**
+    * Decodes a histogram encoded by encodeHistogram() into an array the 
+    * caller provides, without allocating memory.
+    *
+    * @param data The encoding.
+    * @param length The number of bytes in the encoding.
+    * @param counts Receives the 256 counts.
+    * @return False if the encoding is malformed, including a count that 
+    * does not fit in 64 bits, or of a later version, in which case the 
+    * content of counts is unspecified.
+    */
+    inline bool decodeHistogram(const unsigned char *data, size_t length, uint64_t counts[256])
+    {
+        if (length == 0 || data[0] != HISTOGRAM_ENCODING_VERSION)
+        {
+            return false;
+        }
+
+        size_t position = 1;
+        for (int value = 0; value < 256; ++value)
+        {
+            uint64_t count = 0;
+            for (int shift = 0; ; shift += 7)
+            {
+                if (position == length || shift > 63)
+                {
+                    return false;
+                }
+
+                // The tenth byte holds only the top bit of a count; more bits
+                // would overflow it.
+                unsigned char byte = data[position++];
+                if (shift == 63 && (byte & 0x7E) != 0)
+                {
+                    return false;
+                }
+
+                count |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    break;
+                }
+            }
+
+            counts[value] = count;
+        }
+
+        return position == length;
+    }
+}
+
+#endif
@@ -0,0 +1,283 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file LocalFileReader.cpp
+* Contains the implementation of a class that reads a local file from start 
+* to end with hints to the operating system's file cache.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "LocalFileReader.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <sstream>
+#ifdef _WIN32
+#include <windows.h>
+#include "Poco/UnicodeConverter.h"
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace EntropyModule
+{
+    LocalFileReader::LocalFileReader() :
+#ifdef _WIN32
+        m_file(INVALID_HANDLE_VALUE),
+#else
+        m_file(-1),
+#endif
+        m_size(0),
+        m_offset(0),
+        m_bypassCache(false),
+        m_dropAfterRead(false)
+    {
+    }
+
+    LocalFileReader::~LocalFileReader()
+    {
+        close();
+    }
+
+    bool LocalFileReader::open(const std::string &path, Caching caching)
+    {
+        close();
+
+#ifdef _WIN32
+        // Windows has no way to drop pages from the cache, but its cache 
+        // manager already reuses the pages of sequentially scanned files 
+        // first.
+        Poco::UnicodeConverter::toUTF16(path, m_path);
+        DWORD flags = FILE_FLAG_SEQUENTIAL_SCAN;
+        if (caching == BYPASS_CACHE)
+        {
+            m_file = CreateFileW(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags | FILE_FLAG_NO_BUFFERING, NULL);
+            m_bypassCache = m_file != INVALID_HANDLE_VALUE;
+        }
+
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            m_file = CreateFileW(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+        }
+
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size))
+        {
+            close();
+            return false;
+        }
+
+        m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+        // File systems such as tmpfs refuse direct I/O, in which case the 
+        // file is read through the cache.
+#ifdef O_DIRECT
+        if (caching == BYPASS_CACHE)
+        {
+            m_file = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+            m_bypassCache = m_file >= 0;
+        }
+#endif
+
+        if (m_file < 0)
+        {
+            m_file = ::open(path.c_str(), O_RDONLY);
+        }
+
+        if (m_file < 0)
+        {
+            return false;
+        }
+
+        struct stat status;
+        if (fstat(m_file, &status) != 0 || !S_ISREG(status.st_mode))
+        {
+            close();
+            return false;
+        }
+
+        m_size = static_cast<uint64_t>(status.st_size);
+#ifdef F_NOCACHE
+        if (caching == BYPASS_CACHE)
+        {
+            m_bypassCache = fcntl(m_file, F_NOCACHE, 1) == 0;
+        }
+#endif
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(m_file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        m_dropAfterRead = !m_bypassCache && caching != CACHE_NORMALLY;
+#endif
+        return true;
+    }
+
+    size_t LocalFileReader::read(char *buffer, size_t length)
+    {
+        // A short read that reaches the end leaves the position unaligned,
+        // so unbuffered reads must not read again.
+        if (m_offset >= m_size)
+        {
+            return 0;
+        }
+
+        size_t total = 0;
+        while (total < length)
+        {
+#ifdef _WIN32
+            DWORD bytesRead = 0;
+            DWORD part = static_cast<DWORD>(std::min<size_t>(length - total, 1U << 30));
+            if (!ReadFile(m_file, buffer + total, part, &bytesRead, NULL))
+            {
+                if (GetLastError() == ERROR_INVALID_PARAMETER && m_bypassCache && stopBypassingCache(m_offset + total))
+                {
+                    continue;
+                }
+
+                std::ostringstream msg;
+                msg << "failed to read " << part << " bytes at offset " << m_offset + total << ", error " << GetLastError();
+                throw TskException(msg.str());
+            }
+#else
+            ssize_t bytesRead = ::read(m_file, buffer + total, length - total);
+            if (bytesRead < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                if (errno == EINVAL && m_bypassCache && stopBypassingCache(m_offset + total))
+                {
+                    continue;
+                }
+
+                std::ostringstream msg;
+                msg << "failed to read " << length - total << " bytes at offset " << m_offset + total << ", errno " << errno;
+                throw TskException(msg.str());
+            }
+#endif
+            if (bytesRead == 0)
+            {
+                break;
+            }
+
+            total += static_cast<size_t>(bytesRead);
+            if (m_bypassCache)
+            {
+                break;
+            }
+        }
+
+#ifdef POSIX_FADV_DONTNEED
+        if (m_dropAfterRead && total > 0)
+        {
+            posix_fadvise(m_file, static_cast<off_t>(m_offset), static_cast<off_t>(total), POSIX_FADV_DONTNEED);
+        }
+#endif
+        m_offset += total;
+        return total;
+    }
+
+    bool LocalFileReader::stopBypassingCache(uint64_t offset)
+    {
+#ifdef _WIN32
+        // Unbuffered handles cannot be changed, so the file is opened 
+        // again.
+        HANDLE file = CreateFileW(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(offset);
+        if (!SetFilePointerEx(file, position, NULL, FILE_BEGIN))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        CloseHandle(m_file);
+        m_file = file;
+        m_bypassCache = false;
+        return true;
+#elif defined(O_DIRECT)
+        // The descriptor keeps its position, so only the flag is cleared.
+        (void)offset;
+        int flags = fcntl(m_file, F_GETFL);
+        if (flags < 0 || (flags & O_DIRECT) == 0 || fcntl(m_file, F_SETFL, flags & ~O_DIRECT) != 0)
+        {
+            return false;
+        }
+
+        m_bypassCache = false;
+        m_dropAfterRead = true;
+        return true;
+#else
+        (void)offset;
+        return false;
+#endif
+    }
+
+    void LocalFileReader::close()
+    {
+#ifdef _WIN32
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+
+        m_path.clear();
+#else
+        if (m_file >= 0)
+        {
+            ::close(m_file);
+            m_file = -1;
+        }
+#endif
+        m_size = 0;
+        m_offset = 0;
+        m_bypassCache = false;
+        m_dropAfterRead = false;
+    }
+}
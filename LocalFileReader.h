@@ -0,0 +1,136 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file LocalFileReader.h
+* Contains the interface of a class that reads a local file from start to 
+* end with hints to the operating system's file cache.
+*/
+
+#ifndef _ENTROPY_LOCALFILEREADER_H
+#define _ENTROPY_LOCALFILEREADER_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace EntropyModule
+{
+    /**
+    * Reads a local file sequentially, telling the operating system that the
+    * file is read once from start to end so it reads ahead aggressively. 
+    * The reader can also bypass the file cache, or drop the pages it has
+    * read from the cache, so that a single pass over a large file does not 
+    * evict data other modules still need.
+    */
+    class LocalFileReader
+    {
+    public:
+        /**
+        * How the file's content is cached.
+        */
+        enum Caching
+        {
+            /**
+            * Cache the content as usual.
+            */
+            CACHE_NORMALLY,
+
+            /**
+            * Drop the content from the cache once it has been read, where the
+            * system supports it.
+            */
+            DROP_AFTER_READ,
+
+            /**
+            * Read the content without the cache. Buffers and lengths must 
+            * then be multiples of the buffer alignment, and each read is a
+            * single call to the system. Falls back to DROP_AFTER_READ where
+            * the system or the file system does not support it, including 
+            * a file system that lets the file be opened this way but 
+            * refuses the reads.
+            */
+            BYPASS_CACHE
+        };
+
+        LocalFileReader();
+        ~LocalFileReader();
+
+        /**
+        * Opens a file for reading from its start.
+        *
+        * @param path The path of the file.
+        * @param caching How the file's content is cached.
+        * @return False if the file cannot be opened.
+        */
+        bool open(const std::string &path, Caching caching);
+
+        /**
+        * @return The size of the open file in bytes.
+        */
+        uint64_t size() const { return m_size; }
+
+        /**
+        * Reads the next content of the open file.
+        *
+        * @param buffer Receives the content.
+        * @param length The number of bytes to read.
+        * @return The number of bytes read, 0 at the end of the file.
+        * @throws TskException if the content cannot be read.
+        */
+        size_t read(char *buffer, size_t length);
+
+    private:
+        // Not copyable.
+        LocalFileReader(const LocalFileReader&);
+        LocalFileReader &operator=(const LocalFileReader&);
+
+        void close();
+
+        // Reads the rest of the file through the cache after a direct read 
+        // was refused, continuing at the given offset. Returns false if the
+        // file could not be switched.
+        bool stopBypassingCache(uint64_t offset);
+
+#ifdef _WIN32
+        void *m_file;
+        std::wstring m_path;
+#else
+        int m_file;
+#endif
+        uint64_t m_size;
+        uint64_t m_offset;
+        bool m_bypassCache;
+        bool m_dropAfterRead;
+    };
+}
+
+#endif
@@ -0,0 +1,349 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MappedFile.cpp
+* Contains the implementation of a class that maps windows of a local file
+* into memory.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "MappedFile.h"
+
+// C/C++ library includes
+#include <sstream>
+#ifdef _WIN32
+#include <windows.h>
+#include <winioctl.h>
+#include "Poco/UnicodeConverter.h"
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+    // PrefetchVirtualMemory() is only available from Windows 8 on, so it is
+    // looked up at run time.
+    struct MemoryRange
+    {
+        PVOID address;
+        SIZE_T length;
+    };
+
+    typedef BOOL (WINAPI *PrefetchVirtualMemoryFunction)(HANDLE, ULONG_PTR, MemoryRange*, ULONG);
+
+    PrefetchVirtualMemoryFunction findPrefetchVirtualMemory()
+    {
+        HMODULE kernel = GetModuleHandleW(L"kernel32.dll");
+        return kernel != NULL ? reinterpret_cast<PrefetchVirtualMemoryFunction>(GetProcAddress(kernel, "PrefetchVirtualMemory")) : NULL;
+    }
+
+    const PrefetchVirtualMemoryFunction prefetchVirtualMemory = findPrefetchVirtualMemory();
+
+    uint64_t mappingGranularity()
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+    }
+#else
+    uint64_t mappingGranularity()
+    {
+        return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+
+    // Windows must start at a multiple of this.
+    const uint64_t GRANULARITY = mappingGranularity();
+}
+
+namespace EntropyModule
+{
+    MappedFile::MappedFile() :
+#ifdef _WIN32
+        m_file(INVALID_HANDLE_VALUE),
+        m_mapping(NULL),
+#else
+        m_file(-1),
+#endif
+        m_size(0),
+        m_dropPages(false),
+        m_view(NULL),
+        m_viewOffset(0),
+        m_viewLength(0)
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    bool MappedFile::open(const std::string &path, bool dropPages)
+    {
+        close();
+        m_dropPages = dropPages;
+
+#ifdef _WIN32
+        std::wstring widePath;
+        Poco::UnicodeConverter::toUTF16(path, widePath);
+        m_file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+        {
+            close();
+            return false;
+        }
+
+        m_mapping = CreateFileMappingW(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_mapping == NULL)
+        {
+            close();
+            return false;
+        }
+
+        m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+        m_file = ::open(path.c_str(), O_RDONLY);
+        if (m_file < 0)
+        {
+            return false;
+        }
+
+        struct stat status;
+        if (fstat(m_file, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size == 0)
+        {
+            close();
+            return false;
+        }
+
+        m_size = static_cast<uint64_t>(status.st_size);
+#endif
+        return true;
+    }
+
+    const char *MappedFile::map(uint64_t offset, size_t length)
+    {
+        unmap();
+
+        // Start the view on a boundary the system accepts and skip the bytes
+        // before the offset.
+        uint64_t start = offset / GRANULARITY * GRANULARITY;
+        size_t skip = static_cast<size_t>(offset - start);
+        size_t viewLength = skip + length;
+
+#ifdef _WIN32
+        void *view = MapViewOfFile(m_mapping, FILE_MAP_READ, static_cast<DWORD>(start >> 32), static_cast<DWORD>(start), viewLength);
+        if (view == NULL)
+        {
+            std::ostringstream msg;
+            msg << "failed to map " << length << " bytes at offset " << offset << ", error " << GetLastError();
+            throw TskException(msg.str());
+        }
+
+        if (prefetchVirtualMemory != NULL)
+        {
+            MemoryRange range = { view, viewLength };
+            prefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+#else
+        void *view = mmap(NULL, viewLength, PROT_READ, MAP_SHARED, m_file, static_cast<off_t>(start));
+        if (view == MAP_FAILED)
+        {
+            std::ostringstream msg;
+            msg << "failed to map " << length << " bytes at offset " << offset;
+            throw TskException(msg.str());
+        }
+
+        madvise(view, viewLength, MADV_SEQUENTIAL);
+        madvise(view, viewLength, MADV_WILLNEED);
+#endif
+        m_view = view;
+        m_viewOffset = start;
+        m_viewLength = viewLength;
+        return static_cast<const char*>(view) + skip;
+    }
+
+    void MappedFile::dataRanges(std::vector<FileRange> &ranges) const
+    {
+        ranges.clear();
+        FileRange whole = { 0, m_size };
+
+#ifdef _WIN32
+        // The file system lists the allocated ranges; a file that is not 
+        // sparse is allocated in full.
+        FILE_ALLOCATED_RANGE_BUFFER query;
+        query.FileOffset.QuadPart = 0;
+        query.Length.QuadPart = static_cast<LONGLONG>(m_size);
+        FILE_ALLOCATED_RANGE_BUFFER allocated[64];
+        for (;;)
+        {
+            DWORD bytesReturned = 0;
+            BOOL succeeded = DeviceIoControl(m_file, FSCTL_QUERY_ALLOCATED_RANGES, &query, sizeof(query), 
+                allocated, sizeof(allocated), &bytesReturned, NULL);
+            if (!succeeded && GetLastError() != ERROR_MORE_DATA)
+            {
+                ranges.assign(1, whole);
+                return;
+            }
+
+            DWORD count = bytesReturned / sizeof(allocated[0]);
+            for (DWORD i = 0; i < count; ++i)
+            {
+                FileRange range = { static_cast<uint64_t>(allocated[i].FileOffset.QuadPart), static_cast<uint64_t>(allocated[i].Length.QuadPart) };
+                ranges.push_back(range);
+            }
+
+            if (succeeded || count == 0)
+            {
+                break;
+            }
+
+            // Ask for the ranges after the last one returned.
+            LONGLONG end = allocated[count - 1].FileOffset.QuadPart + allocated[count - 1].Length.QuadPart;
+            if (end >= static_cast<LONGLONG>(m_size))
+            {
+                break;
+            }
+
+            query.Length.QuadPart = static_cast<LONGLONG>(m_size) - end;
+            query.FileOffset.QuadPart = end;
+        }
+#elif defined(SEEK_DATA) && defined(SEEK_HOLE)
+        off_t position = 0;
+        while (static_cast<uint64_t>(position) < m_size)
+        {
+            off_t data = lseek(m_file, position, SEEK_DATA);
+            if (data < 0)
+            {
+                if (errno == ENXIO)
+                {
+                    // Only a hole is left.
+                    break;
+                }
+
+                ranges.assign(1, whole);
+                return;
+            }
+
+            off_t hole = lseek(m_file, data, SEEK_HOLE);
+            if (hole < 0)
+            {
+                ranges.assign(1, whole);
+                return;
+            }
+
+            FileRange range = { static_cast<uint64_t>(data), static_cast<uint64_t>(hole - data) };
+            ranges.push_back(range);
+            position = hole;
+        }
+#else
+        ranges.push_back(whole);
+#endif
+
+        // The file may have changed size since it was opened.
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            if (ranges[i].offset >= m_size)
+            {
+                ranges.resize(i);
+                break;
+            }
+
+            if (ranges[i].length > m_size - ranges[i].offset)
+            {
+                ranges[i].length = m_size - ranges[i].offset;
+            }
+        }
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_view == NULL)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_view);
+#else
+        munmap(m_view, m_viewLength);
+#ifdef POSIX_FADV_DONTNEED
+        // Unmapped pages are clean, so the cache can simply discard them.
+        if (m_dropPages)
+        {
+            posix_fadvise(m_file, static_cast<off_t>(m_viewOffset), static_cast<off_t>(m_viewLength), POSIX_FADV_DONTNEED);
+        }
+#endif
+#endif
+        m_view = NULL;
+        m_viewOffset = 0;
+        m_viewLength = 0;
+    }
+
+    void MappedFile::close()
+    {
+        unmap();
+
+#ifdef _WIN32
+        if (m_mapping != NULL)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = NULL;
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_file >= 0)
+        {
+            ::close(m_file);
+            m_file = -1;
+        }
+#endif
+        m_size = 0;
+    }
+}
@@ -0,0 +1,132 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MappedFile.h
+* Contains the interface of a class that maps windows of a local file into
+* memory.
+*/
+
+#ifndef _ENTROPY_MAPPEDFILE_H
+#define _ENTROPY_MAPPEDFILE_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace EntropyModule
+{
+    /**
+    * A range of bytes in a file.
+    */
+    struct FileRange
+    {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    /**
+    * Maps a local file into memory one window at a time, so its content can
+    * be examined without being copied into a buffer. The operating system 
+    * is told the file will be read sequentially, and each window is 
+    * prefetched when it is mapped. Optionally, each window's pages are 
+    * dropped from the file cache once the window is replaced.
+    *
+    * An I/O error while a mapped page is being read is raised as a signal
+    * or structured exception rather than a C++ exception, so only files on
+    * local storage should be mapped.
+    */
+    class MappedFile
+    {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        /**
+        * Opens a file for mapping.
+        *
+        * @param path The path of the file.
+        * @param dropPages Whether to drop the pages of each window from the
+        * file cache when it is unmapped, where the system supports it.
+        * @return False if the file cannot be opened or mapped.
+        */
+        bool open(const std::string &path, bool dropPages);
+
+        /**
+        * @return The size of the open file in bytes.
+        */
+        uint64_t size() const { return m_size; }
+
+        /**
+        * Maps a window of the open file, replacing the previous window. 
+        *
+        * @param offset The offset of the first byte of the window.
+        * @param length The length of the window in bytes; the window must 
+        * lie within the file.
+        * @return The address of the byte at the offset.
+        * @throws TskException if the window cannot be mapped.
+        */
+        const char *map(uint64_t offset, size_t length);
+
+        /**
+        * Finds the ranges of the open file that hold data. The rest of the
+        * file consists of holes, which read as zeros without any I/O. A 
+        * file that is not sparse, or whose file system cannot tell, is a 
+        * single range.
+        *
+        * @param ranges Receives the ranges in file order.
+        */
+        void dataRanges(std::vector<FileRange> &ranges) const;
+
+    private:
+        // Not copyable.
+        MappedFile(const MappedFile&);
+        MappedFile &operator=(const MappedFile&);
+
+        void unmap();
+        void close();
+
+#ifdef _WIN32
+        void *m_file;
+        void *m_mapping;
+#else
+        int m_file;
+#endif
+        uint64_t m_size;
+        bool m_dropPages;
+        void *m_view;
+        uint64_t m_viewOffset;
+        size_t m_viewLength;
+    };
+}
+
+#endif
@@ -0,0 +1,598 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ModuleConfig.cpp
+* Contains the implementation of the module's configuration settings and the
+* parser for the module's initialization arguments.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ModuleConfig.h"
+#include "AlignedBuffer.h"
+#include "ByteHistogram.h"
+
+// Poco includes
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
+#include "Poco/StringTokenizer.h"
+
+// C/C++ library includes
+#include <sstream>
+
+namespace
+{
+    const size_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+    const uint64_t MAX_BUFFER_SIZE = 1024 * 1024 * 1024;
+    const uint64_t MAX_READ_AHEAD_DEPTH = 64;
+    const uint64_t MAX_CHUNK_THREADS = 256;
+    const uint64_t MAX_CHUNK_HELP = 1024;
+    const size_t DEFAULT_SMALL_FILE_SIZE = 64 * 1024;
+    const uint64_t DEFAULT_CHUNK_THRESHOLD = 1024ULL * 1024 * 1024;
+    const uint64_t DEFAULT_CHUNK_SIZE = 64 * 1024 * 1024;
+    const size_t DEFAULT_MAP_WINDOW = 64 * 1024 * 1024;
+    const double DEFAULT_BAND_TEXT = 3.0;
+    const double DEFAULT_BAND_COMPRESSED = 6.0;
+    const double DEFAULT_BAND_ENCRYPTED = 7.5;
+    const uint64_t MAX_BLOCK_SIZE = 1024 * 1024;
+    const double DEFAULT_BLOCK_THRESHOLD = 7.5;
+    const size_t DEFAULT_SAMPLE_BLOCK_SIZE = 64 * 1024;
+    const uint64_t MAX_SAMPLE_BLOCK_SIZE = 16 * 1024 * 1024;
+    const size_t DEFAULT_PYRAMID_BLOCK_SIZE = 4 * 1024;
+    const uint64_t MAX_PYRAMID_BLOCK_SIZE = 16 * 1024 * 1024;
+    const size_t DEFAULT_PYRAMID_LEVELS = 4;
+    const uint64_t MAX_PYRAMID_LEVELS = 8;
+    const double DEFAULT_SAMPLE_EPSILON = 0.01;
+    const uint64_t DEFAULT_SAMPLE_MIN_BLOCKS = 32;
+    const uint64_t MAX_CACHE_ENTRIES = 16 * 1024 * 1024;
+
+    uint64_t roundUpToAlignment(uint64_t size)
+    {
+        return (size + EntropyModule::AlignedBuffer::ALIGNMENT - 1) / EntropyModule::AlignedBuffer::ALIGNMENT * EntropyModule::AlignedBuffer::ALIGNMENT;
+    }
+
+    void throwBadValue(const std::string &name, const std::string &value)
+    {
+        throw TskException("invalid value '" + value + "' for argument '" + name + "'");
+    }
+
+    /**
+    * Parses a non-negative integer.
+    */
+    uint64_t parseUnsigned(const std::string &name, const std::string &value)
+    {
+        Poco::UInt64 number = 0;
+        if (!Poco::NumberParser::tryParseUnsigned64(value, number))
+        {
+            throwBadValue(name, value);
+        }
+
+        return number;
+    }
+
+    /**
+    * Parses a floating point number.
+    */
+    double parseDouble(const std::string &name, const std::string &value)
+    {
+        double number = 0.0;
+        if (!Poco::NumberParser::tryParseFloat(value, number))
+        {
+            throwBadValue(name, value);
+        }
+
+        return number;
+    }
+
+    /**
+    * Parses an entropy value, between 0 and 8 bits.
+    */
+    double parseEntropy(const std::string &name, const std::string &value)
+    {
+        double entropy = parseDouble(name, value);
+        if (!(entropy >= 0.0 && entropy <= 8.0))
+        {
+            throwBadValue(name, value);
+        }
+
+        return entropy;
+    }
+
+    /**
+    * Parses true/false, yes/no or 1/0.
+    */
+    bool parseBool(const std::string &name, const std::string &value)
+    {
+        std::string lower = Poco::toLower(value);
+        if (lower == "true" || lower == "yes" || lower == "1")
+        {
+            return true;
+        }
+        
+        if (lower == "false" || lower == "no" || lower == "0")
+        {
+            return false;
+        }
+
+        throwBadValue(name, value);
+        return false;
+    }
+
+    /**
+    * Parses the name of an I/O policy.
+    */
+    EntropyModule::ModuleConfig::IoPolicy parseIoPolicy(const std::string &name, const std::string &value)
+    {
+        std::string lower = Poco::toLower(value);
+        if (lower == "framework")
+        {
+            return EntropyModule::ModuleConfig::IO_FRAMEWORK;
+        }
+
+        if (lower == "sequential")
+        {
+            return EntropyModule::ModuleConfig::IO_SEQUENTIAL;
+        }
+
+        if (lower == "noreuse")
+        {
+            return EntropyModule::ModuleConfig::IO_NOREUSE;
+        }
+
+        if (lower == "direct")
+        {
+            return EntropyModule::ModuleConfig::IO_DIRECT;
+        }
+
+        throwBadValue(name, value);
+        return EntropyModule::ModuleConfig::IO_FRAMEWORK;
+    }
+
+    /**
+    * Parses a byte count with an optional K, M or G suffix.
+    */
+    uint64_t parseSize(const std::string &name, const std::string &value)
+    {
+        std::string digits = value;
+        uint64_t multiplier = 1;
+        if (!digits.empty())
+        {
+            switch (digits[digits.size() - 1])
+            {
+            case 'k': case 'K': multiplier = 1024ULL; break;
+            case 'm': case 'M': multiplier = 1024ULL * 1024; break;
+            case 'g': case 'G': multiplier = 1024ULL * 1024 * 1024; break;
+            }
+
+            if (multiplier != 1)
+            {
+                digits.erase(digits.size() - 1);
+            }
+        }
+
+        Poco::UInt64 number = 0;
+        if (!Poco::NumberParser::tryParseUnsigned64(digits, number) || number > 0xFFFFFFFFFFFFFFFFULL / multiplier)
+        {
+            throwBadValue(name, value);
+        }
+
+        return number * multiplier;
+    }
+}
+
+namespace EntropyModule
+{
+    ModuleConfig::ModuleConfig() :
+        bufferSize(DEFAULT_BUFFER_SIZE),
+        readAheadDepth(0),
+        smallFileSize(DEFAULT_SMALL_FILE_SIZE),
+        chunkThreads(0),
+        chunkThreshold(DEFAULT_CHUNK_THRESHOLD),
+        chunkSize(DEFAULT_CHUNK_SIZE),
+        chunkHelp(0),
+        gpuThreshold(0),
+        mapFiles(false),
+        mapWindow(DEFAULT_MAP_WINDOW),
+        ioPolicy(IO_FRAMEWORK),
+        maxBytes(0),
+        maxSeconds(0.0),
+        postBand(false),
+        bandText(DEFAULT_BAND_TEXT),
+        bandCompressed(DEFAULT_BAND_COMPRESSED),
+        bandEncrypted(DEFAULT_BAND_ENCRYPTED),
+        blockSize(0),
+        blockStride(0),
+        blockThreshold(DEFAULT_BLOCK_THRESHOLD),
+        blockSeries(false),
+        pyramidBlockSize(DEFAULT_PYRAMID_BLOCK_SIZE),
+        pyramidLevels(DEFAULT_PYRAMID_LEVELS),
+        sampleAbove(0),
+        sampleBlockSize(DEFAULT_SAMPLE_BLOCK_SIZE),
+        sampleEpsilon(DEFAULT_SAMPLE_EPSILON),
+        sampleMinBlocks(DEFAULT_SAMPLE_MIN_BLOCKS),
+        renyiEntropy(false),
+        chiSquare(false),
+        mean(false),
+        serialCorrelation(false),
+        monteCarloPi(false),
+        postHistogram(false),
+        cacheEntries(0),
+        resumeEntries(0),
+        skipKnown(false),
+        skipEmpty(false),
+        skipBelow(0),
+        skipAbove(0)
+    {
+    }
+
+    void parseModuleConfig(const std::string &arguments, ModuleConfig &config)
+    {
+        Poco::StringTokenizer tokens(arguments, ";", Poco::StringTokenizer::TOK_IGNORE_EMPTY | Poco::StringTokenizer::TOK_TRIM);
+        for (Poco::StringTokenizer::Iterator it = tokens.begin(); it != tokens.end(); ++it)
+        {
+            std::string::size_type separator = it->find('=');
+            if (separator == std::string::npos)
+            {
+                throw TskException("malformed argument '" + *it + "', expected name=value");
+            }
+
+            std::string name = Poco::toLower(Poco::trim(it->substr(0, separator)));
+            std::string value = Poco::trim(it->substr(separator + 1));
+
+            if (name == "buffer_size")
+            {
+                uint64_t size = parseSize(name, value);
+                if (size == 0 || size > MAX_BUFFER_SIZE)
+                {
+                    throwBadValue(name, value);
+                }
+
+                // Keep the size a multiple of the alignment so the buffer can
+                // be used for unbuffered I/O.
+                config.bufferSize = static_cast<size_t>(roundUpToAlignment(size));
+            }
+            else if (name == "read_ahead")
+            {
+                // A ring needs a buffer being filled and one being counted.
+                uint64_t depth = parseUnsigned(name, value);
+                if (depth == 1 || depth > MAX_READ_AHEAD_DEPTH)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.readAheadDepth = static_cast<size_t>(depth);
+            }
+            else if (name == "small_file_size")
+            {
+                uint64_t size = parseSize(name, value);
+                if (size > ByteHistogram::SMALL_BUFFER_LIMIT)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.smallFileSize = static_cast<size_t>(size);
+            }
+            else if (name == "chunk_threads")
+            {
+                uint64_t threads = parseUnsigned(name, value);
+                if (threads > MAX_CHUNK_THREADS)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.chunkThreads = static_cast<size_t>(threads);
+            }
+            else if (name == "chunk_threshold")
+            {
+                config.chunkThreshold = parseSize(name, value);
+            }
+            else if (name == "chunk_size")
+            {
+                uint64_t size = parseSize(name, value);
+                if (size == 0 || size > 0xFFFFFFFFFFFFFFFFULL - AlignedBuffer::ALIGNMENT)
+                {
+                    throwBadValue(name, value);
+                }
+
+                // Chunk boundaries stay aligned for unbuffered I/O.
+                config.chunkSize = roundUpToAlignment(size);
+            }
+            else if (name == "chunk_help")
+            {
+                uint64_t chunks = parseUnsigned(name, value);
+                if (chunks > MAX_CHUNK_HELP)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.chunkHelp = static_cast<size_t>(chunks);
+            }
+            else if (name == "gpu_threshold")
+            {
+                config.gpuThreshold = parseSize(name, value);
+            }
+            else if (name == "map_files")
+            {
+                config.mapFiles = parseBool(name, value);
+            }
+            else if (name == "map_window")
+            {
+                uint64_t size = parseSize(name, value);
+                if (size == 0 || size > MAX_BUFFER_SIZE)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.mapWindow = static_cast<size_t>(roundUpToAlignment(size));
+            }
+            else if (name == "io_policy")
+            {
+                config.ioPolicy = parseIoPolicy(name, value);
+            }
+            else if (name == "max_bytes")
+            {
+                config.maxBytes = parseSize(name, value);
+            }
+            else if (name == "max_seconds")
+            {
+                double seconds = parseDouble(name, value);
+                if (seconds < 0.0)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.maxSeconds = seconds;
+            }
+            else if (name == "post_band")
+            {
+                config.postBand = parseBool(name, value);
+            }
+            else if (name == "band_text")
+            {
+                config.bandText = parseEntropy(name, value);
+            }
+            else if (name == "band_compressed")
+            {
+                config.bandCompressed = parseEntropy(name, value);
+            }
+            else if (name == "band_encrypted")
+            {
+                config.bandEncrypted = parseEntropy(name, value);
+            }
+            else if (name == "block_size")
+            {
+                uint64_t size = parseSize(name, value);
+                if (size > MAX_BLOCK_SIZE)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.blockSize = static_cast<size_t>(size);
+            }
+            else if (name == "block_stride")
+            {
+                uint64_t stride = parseSize(name, value);
+                if (stride == 0 || stride > MAX_BLOCK_SIZE)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.blockStride = static_cast<size_t>(stride);
+            }
+            else if (name == "block_threshold")
+            {
+                config.blockThreshold = parseEntropy(name, value);
+            }
+            else if (name == "block_series")
+            {
+                config.blockSeries = parseBool(name, value);
+            }
+            else if (name == "pyramid_dir")
+            {
+                config.pyramidDir = value;
+            }
+            else if (name == "pyramid_block_size")
+            {
+                uint64_t size = parseSize(name, value);
+                if (size == 0 || size > MAX_PYRAMID_BLOCK_SIZE)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.pyramidBlockSize = static_cast<size_t>(size);
+            }
+            else if (name == "pyramid_levels")
+            {
+                uint64_t levels = parseUnsigned(name, value);
+                if (levels == 0 || levels > MAX_PYRAMID_LEVELS)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.pyramidLevels = static_cast<size_t>(levels);
+            }
+            else if (name == "sample_above")
+            {
+                config.sampleAbove = parseSize(name, value);
+            }
+            else if (name == "sample_block_size")
+            {
+                uint64_t size = parseSize(name, value);
+                if (size == 0 || size > MAX_SAMPLE_BLOCK_SIZE)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.sampleBlockSize = static_cast<size_t>(roundUpToAlignment(size));
+            }
+            else if (name == "sample_epsilon")
+            {
+                double epsilon = parseDouble(name, value);
+                if (!(epsilon > 0.0))
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.sampleEpsilon = epsilon;
+            }
+            else if (name == "sample_min_blocks")
+            {
+                uint64_t blocks = parseUnsigned(name, value);
+                if (blocks < 2)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.sampleMinBlocks = blocks;
+            }
+            else if (name == "renyi_entropy")
+            {
+                config.renyiEntropy = parseBool(name, value);
+            }
+            else if (name == "chi_square")
+            {
+                config.chiSquare = parseBool(name, value);
+            }
+            else if (name == "mean")
+            {
+                config.mean = parseBool(name, value);
+            }
+            else if (name == "serial_correlation")
+            {
+                config.serialCorrelation = parseBool(name, value);
+            }
+            else if (name == "monte_carlo_pi")
+            {
+                config.monteCarloPi = parseBool(name, value);
+            }
+            else if (name == "post_histogram")
+            {
+                config.postHistogram = parseBool(name, value);
+            }
+            else if (name == "cache_entries")
+            {
+                uint64_t entries = parseUnsigned(name, value);
+                if (entries > MAX_CACHE_ENTRIES)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.cacheEntries = static_cast<size_t>(entries);
+            }
+            else if (name == "cache_file")
+            {
+                config.cacheFile = value;
+            }
+            else if (name == "resume_entries")
+            {
+                uint64_t entries = parseUnsigned(name, value);
+                if (entries > MAX_CACHE_ENTRIES)
+                {
+                    throwBadValue(name, value);
+                }
+
+                config.resumeEntries = static_cast<size_t>(entries);
+            }
+            else if (name == "resume_file")
+            {
+                config.resumeFile = value;
+            }
+            else if (name == "skip_known")
+            {
+                config.skipKnown = parseBool(name, value);
+            }
+            else if (name == "skip_empty")
+            {
+                config.skipEmpty = parseBool(name, value);
+            }
+            else if (name == "skip_below")
+            {
+                config.skipBelow = parseSize(name, value);
+            }
+            else if (name == "skip_above")
+            {
+                config.skipAbove = parseSize(name, value);
+            }
+            else
+            {
+                throw TskException("unrecognized argument '" + name + "'");
+            }
+        }
+
+        if (config.blockStride == 0)
+        {
+            config.blockStride = config.blockSize;
+        }
+
+        if (config.bandText > config.bandCompressed || config.bandCompressed > config.bandEncrypted)
+        {
+            throw TskException("band_text, band_compressed and band_encrypted must be in ascending order");
+        }
+
+        if (config.skipAbove > 0 && config.skipBelow > config.skipAbove)
+        {
+            throw TskException("skip_below is larger than skip_above, so every file would be skipped");
+        }
+    }
+
+    std::string resultSignature(const ModuleConfig &config)
+    {
+        // Only settings that change what is posted belong here; buffer and
+        // threading settings change how fast a result is computed, not the
+        // result itself.
+        std::stringstream signature;
+        signature.precision(17);
+        signature << "b" << config.blockSize << "," << config.blockStride << "," << config.blockThreshold << "," << config.blockSeries;
+        signature << ";p" << config.pyramidDir;
+        if (!config.pyramidDir.empty())
+        {
+            signature << "," << config.pyramidBlockSize << "," << config.pyramidLevels;
+        }
+
+        signature << ";s" << config.sampleAbove;
+        if (config.sampleAbove > 0)
+        {
+            signature << "," << config.sampleBlockSize << "," << config.sampleEpsilon << "," << config.sampleMinBlocks;
+        }
+
+        signature << ";e" << config.postBand;
+        if (config.postBand)
+        {
+            signature << "," << config.bandText << "," << config.bandCompressed << "," << config.bandEncrypted;
+        }
+
+        signature << ";t" << config.renyiEntropy << config.chiSquare << config.mean << config.serialCorrelation << config.monteCarloPi << config.postHistogram;
+
+        return signature.str();
+    }
+}
@@ -0,0 +1,352 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ModuleConfig.h
+* Contains the interface of the module's configuration settings and the
+* parser for the module's initialization arguments.
+*/
+
+#ifndef _ENTROPY_MODULECONFIG_H
+#define _ENTROPY_MODULECONFIG_H
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace EntropyModule
+{
+    /**
+    * Holds the settings that control how the module processes files. The 
+    * defaults are the settings used when the module is given no arguments.
+    */
+    struct ModuleConfig
+    {
+        /**
+        * How files with a local copy are read ("io_policy").
+        */
+        enum IoPolicy
+        {
+            /**
+            * Read through the framework, like any other file ("framework").
+            */
+            IO_FRAMEWORK,
+
+            /**
+            * Read the local copy, telling the system it is read sequentially
+            * ("sequential").
+            */
+            IO_SEQUENTIAL,
+
+            /**
+            * As IO_SEQUENTIAL, and drop the pages read from the file cache 
+            * ("noreuse").
+            */
+            IO_NOREUSE,
+
+            /**
+            * As IO_SEQUENTIAL, but read without the file cache ("direct").
+            */
+            IO_DIRECT
+        };
+
+        ModuleConfig();
+
+        /**
+        * Size in bytes of the buffer file content is read into 
+        * ("buffer_size"). Always a multiple of the buffer alignment.
+        */
+        size_t bufferSize;
+
+        /**
+        * Number of buffers a reader thread keeps filled ahead of the 
+        * counting code ("read_ahead"). 0 reads on the calling thread.
+        */
+        size_t readAheadDepth;
+
+        /**
+        * Files of at most this many bytes are read with a single call sized 
+        * from the file's metadata ("small_file_size"). 0 disables the small 
+        * file path.
+        */
+        size_t smallFileSize;
+
+        /**
+        * Number of worker threads that count chunks of large files in 
+        * parallel ("chunk_threads"). 0 disables parallel counting.
+        */
+        size_t chunkThreads;
+
+        /**
+        * Files larger than this many bytes are counted in parallel chunks
+        * ("chunk_threshold").
+        */
+        uint64_t chunkThreshold;
+
+        /**
+        * Size in bytes of the chunks large files are split into
+        * ("chunk_size"). Always a multiple of the buffer alignment.
+        */
+        uint64_t chunkSize;
+
+        /**
+        * Maximum number of chunks of other files a thread counts after
+        * each file it analyzes, when parallel counting is enabled 
+        * ("chunk_help").
+        */
+        size_t chunkHelp;
+
+        /**
+        * Files larger than this many bytes are counted on a GPU if one is
+        * available ("gpu_threshold"). 0 disables GPU counting.
+        */
+        uint64_t gpuThreshold;
+
+        /**
+        * Whether to read files that have a local copy on disk by mapping 
+        * the copy into memory ("map_files").
+        */
+        bool mapFiles;
+
+        /**
+        * Size in bytes of the windows local copies are mapped in
+        * ("map_window"). Always a multiple of the buffer alignment.
+        */
+        size_t mapWindow;
+
+        /**
+        * How files with a local copy are read and cached when they are read
+        * sequentially or mapped ("io_policy").
+        */
+        IoPolicy ioPolicy;
+
+        /**
+        * Maximum number of bytes counted for a file ("max_bytes"). A file 
+        * larger than this is posted with partial results. 0 means no limit.
+        */
+        uint64_t maxBytes;
+
+        /**
+        * Maximum time in seconds spent reading a file ("max_seconds"). A 
+        * file that takes longer is posted with partial results. 0 means no 
+        * limit.
+        */
+        double maxSeconds;
+
+        /**
+        * Whether to post the band the entropy of the file falls in
+        * ("post_band").
+        */
+        bool postBand;
+
+        /**
+        * The lowest entropies of the "text", "compressed" and "encrypted" 
+        * bands ("band_text", "band_compressed", "band_encrypted"). Lower 
+        * entropies are in the "low" band. Always in ascending order.
+        */
+        double bandText;
+        double bandCompressed;
+        double bandEncrypted;
+
+        /**
+        * Size in bytes of the blocks whose entropy is profiled 
+        * ("block_size"). 0 disables the block profile.
+        */
+        size_t blockSize;
+
+        /**
+        * Distance in bytes between the starts of profiled blocks 
+        * ("block_stride"). Equal to the block size unless set.
+        */
+        size_t blockStride;
+
+        /**
+        * Blocks with at least this entropy, from 0 to 8 bits, are counted
+        * as high-entropy blocks ("block_threshold").
+        */
+        double blockThreshold;
+
+        /**
+        * Whether to post the quantized entropy of every block 
+        * ("block_series").
+        */
+        bool blockSeries;
+
+        /**
+        * Directory entropy pyramid files are written to ("pyramid_dir"). 
+        * Empty disables the pyramid.
+        */
+        std::string pyramidDir;
+
+        /**
+        * Size in bytes of the finest blocks of the pyramid 
+        * ("pyramid_block_size").
+        */
+        size_t pyramidBlockSize;
+
+        /**
+        * Number of levels of the pyramid, each with blocks 16 times the 
+        * size of the level below ("pyramid_levels").
+        */
+        size_t pyramidLevels;
+
+        /**
+        * Files larger than this many bytes have their entropy estimated 
+        * from a sample of their blocks ("sample_above"). 0 disables 
+        * sampling.
+        */
+        uint64_t sampleAbove;
+
+        /**
+        * Size in bytes of the sampled blocks ("sample_block_size"). Always
+        * a multiple of the buffer alignment.
+        */
+        size_t sampleBlockSize;
+
+        /**
+        * Width in bits of the confidence interval at which sampling stops
+        * ("sample_epsilon").
+        */
+        double sampleEpsilon;
+
+        /**
+        * Minimum number of blocks sampled ("sample_min_blocks").
+        */
+        uint64_t sampleMinBlocks;
+
+        /**
+        * Whether to post the collision and min entropies of the file 
+        * alongside its Shannon entropy ("renyi_entropy").
+        */
+        bool renyiEntropy;
+
+        /**
+        * Whether to post the chi-square statistic of the byte distribution
+        * and its probability ("chi_square").
+        */
+        bool chiSquare;
+
+        /**
+        * Whether to post the arithmetic mean of the bytes ("mean").
+        */
+        bool mean;
+
+        /**
+        * Whether to post the serial correlation coefficient of the bytes
+        * ("serial_correlation").
+        */
+        bool serialCorrelation;
+
+        /**
+        * Whether to post a Monte Carlo estimate of pi computed from the 
+        * bytes ("monte_carlo_pi").
+        */
+        bool monteCarloPi;
+
+        /**
+        * Whether to post the byte histogram of the file so that other 
+        * modules can use it without reading the file ("post_histogram").
+        */
+        bool postHistogram;
+
+        /**
+        * Maximum number of files whose results are cached by content hash
+        * ("cache_entries"). 0 disables the cache.
+        */
+        size_t cacheEntries;
+
+        /**
+        * File the result cache is loaded from at initialization and saved 
+        * to at finalization ("cache_file"). Empty keeps the cache in memory
+        * only.
+        */
+        std::string cacheFile;
+
+        /**
+        * Maximum number of files whose byte counts are kept so that only
+        * data appended to them is counted when they are analyzed again 
+        * ("resume_entries"). 0 disables resuming.
+        */
+        size_t resumeEntries;
+
+        /**
+        * File the resume points are loaded from at initialization and saved
+        * to at finalization ("resume_file"). Empty keeps them in memory 
+        * only.
+        */
+        std::string resumeFile;
+
+        /**
+        * Whether to skip files the image database reports as known, such as
+        * NSRL matches ("skip_known").
+        */
+        bool skipKnown;
+
+        /**
+        * Whether to skip empty files rather than post an entropy of 0 for 
+        * them ("skip_empty").
+        */
+        bool skipEmpty;
+
+        /**
+        * Files smaller than this many bytes are skipped ("skip_below").
+        */
+        uint64_t skipBelow;
+
+        /**
+        * Files larger than this many bytes are skipped ("skip_above"). 0 
+        * skips no files by size.
+        */
+        uint64_t skipAbove;
+    };
+
+    /**
+    * Parses a string of module initialization arguments. Arguments are 
+    * separated by semicolons and take the form "name=value", for example
+    * "buffer_size=4M". Sizes may have a K, M or G suffix.   
+    *
+    * @param arguments The initialization arguments.
+    * @param config Receives the settings.
+    * @throws TskException if an argument is malformed or not recognized.
+    */
+    void parseModuleConfig(const std::string &arguments, ModuleConfig &config);
+
+    /**
+    * Describes the settings that change which results are posted for a 
+    * file, so cached results are only reused under the same settings.
+    *
+    * @param config The settings.
+    * @return A string that differs whenever the results could differ.
+    */
+    std::string resultSignature(const ModuleConfig &config);
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MonteCarloPi.cpp
+* Contains the implementation of a class that estimates pi from a file's
+* bytes.
+*/
+
+// Module includes
+#include "MonteCarloPi.h"
+
+namespace
+{
+    // The squared radius of the circle, in the coordinates' units.
+    const uint64_t RADIUS_SQUARED = 0xFFFFFFULL * 0xFFFFFFULL;
+}
+
+namespace EntropyModule
+{
+    MonteCarloPi::MonteCarloPi()
+    {
+        reset();
+    }
+
+    void MonteCarloPi::reset()
+    {
+        m_points = 0;
+        m_pointsInCircle = 0;
+        m_partialLength = 0;
+    }
+
+    void MonteCarloPi::addPoint(const uint8_t *group)
+    {
+        // The squares fit in 48 bits, so the integer test is exact.
+        uint64_t x = (static_cast<uint64_t>(group[0]) << 16) | (group[1] << 8) | group[2];
+        uint64_t y = (static_cast<uint64_t>(group[3]) << 16) | (group[4] << 8) | group[5];
+        ++m_points;
+        if (x * x + y * y <= RADIUS_SQUARED)
+        {
+            ++m_pointsInCircle;
+        }
+    }
+
+    void MonteCarloPi::add(const uint8_t *data, size_t length)
+    {
+        if (m_partialLength > 0)
+        {
+            while (m_partialLength < GROUP_SIZE && length > 0)
+            {
+                m_partial[m_partialLength++] = *data++;
+                --length;
+            }
+
+            if (m_partialLength < GROUP_SIZE)
+            {
+                return;
+            }
+
+            addPoint(m_partial);
+            m_partialLength = 0;
+        }
+
+        for (; length >= GROUP_SIZE; data += GROUP_SIZE, length -= GROUP_SIZE)
+        {
+            addPoint(data);
+        }
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            m_partial[m_partialLength++] = data[i];
+        }
+    }
+
+    bool MonteCarloPi::estimate(double &estimate) const
+    {
+        if (m_points == 0)
+        {
+            return false;
+        }
+
+        estimate = 4.0 * static_cast<double>(m_pointsInCircle) / static_cast<double>(m_points);
+        return true;
+    }
+}
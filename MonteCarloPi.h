@@ -0,0 +1,86 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MonteCarloPi.h
+* Contains the interface of a class that estimates pi from a file's bytes.
+*/
+
+#ifndef _ENTROPY_MONTECARLOPI_H
+#define _ENTROPY_MONTECARLOPI_H
+
+// Module includes
+#include "ContentAnalyzer.h"
+
+namespace EntropyModule
+{
+    /**
+    * Estimates pi the way ent does, by taking each group of six bytes as the 
+    * 24-bit X and Y coordinates of a point in a square and counting the 
+    * points that fall inside the inscribed quarter circle. The estimate 
+    * approaches pi for random data. Bytes left over after the last full 
+    * group are ignored.
+    */
+    class MonteCarloPi : public ContentAnalyzer
+    {
+    public:
+        MonteCarloPi();
+
+        /**
+        * Prepares the estimate for a new file.
+        */
+        void reset();
+
+        virtual void add(const uint8_t *data, size_t length);
+
+        /**
+        * Computes the estimate.
+        *
+        * @param estimate Receives the estimate of pi.
+        * @return False if the file had fewer than six bytes.
+        */
+        bool estimate(double &estimate) const;
+
+    private:
+        enum { GROUP_SIZE = 6 };
+
+        // Tests one point.
+        void addPoint(const uint8_t *group);
+
+        uint64_t m_points;
+        uint64_t m_pointsInCircle;
+
+        // The start of a group split between calls to add().
+        uint8_t m_partial[GROUP_SIZE];
+        size_t m_partialLength;
+    };
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file PositionalReader.cpp
+* Contains the implementation of classes that read file content at explicit
+* offsets rather than from a file's read cursor.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "PositionalReader.h"
+
+// C/C++ library includes
+#include <sstream>
+
+namespace EntropyModule
+{
+    TskFilePositionalReader::TskFilePositionalReader(TskFile *pFile) :
+        m_pFile(pFile),
+        m_bytesRead(0),
+        m_readCalls(0),
+        m_readTime(0)
+    {
+    }
+
+    size_t TskFilePositionalReader::readAt(uint64_t offset, char *buffer, size_t length)
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        Poco::Timestamp started;
+
+        if (m_pFile->seek(static_cast<TSK_OFF_T>(offset), SEEK_SET) != static_cast<TSK_OFF_T>(offset))
+        {
+            std::ostringstream msg;
+            msg << "failed to seek to offset " << offset;
+            throw TskException(msg.str());
+        }
+
+        size_t total = 0;
+        while (total < length)
+        {
+            ++m_readCalls;
+            ssize_t bytesRead = m_pFile->read(buffer + total, length - total);
+            if (bytesRead <= 0)
+            {
+                break;
+            }
+
+            total += static_cast<size_t>(bytesRead);
+        }
+
+        m_bytesRead += total;
+        m_readTime += started.elapsed();
+        return total;
+    }
+
+    uint64_t TskFilePositionalReader::bytesRead() const
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        return m_bytesRead;
+    }
+
+    uint64_t TskFilePositionalReader::readCalls() const
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        return m_readCalls;
+    }
+
+    Poco::Timestamp::TimeDiff TskFilePositionalReader::readTime() const
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        return m_readTime;
+    }
+}
@@ -0,0 +1,116 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file PositionalReader.h
+* Contains the interface of classes that read file content at explicit
+* offsets rather than from a file's read cursor.
+*/
+
+#ifndef _ENTROPY_POSITIONALREADER_H
+#define _ENTROPY_POSITIONALREADER_H
+
+// Poco includes
+#include "Poco/Mutex.h"
+#include "Poco/Timestamp.h"
+
+// C/C++ library includes
+#include <stddef.h>
+#include <stdint.h>
+
+class TskFile;
+
+namespace EntropyModule
+{
+    /**
+    * Interface for reading file content at an explicit offset. Unlike the
+    * read cursor of a TskFile, implementations may be used by several 
+    * threads at once.
+    */
+    class PositionalReader
+    {
+    public:
+        virtual ~PositionalReader() {}
+
+        /**
+        * Reads file content starting at an offset. Fewer bytes than requested
+        * are only returned at the end of the file.
+        *
+        * @param offset The offset of the first byte to read.
+        * @param buffer Receives the content.
+        * @param length The number of bytes to read.
+        * @return The number of bytes read, 0 at or past the end of the file.
+        * @throws TskException if the content cannot be read.
+        */
+        virtual size_t readAt(uint64_t offset, char *buffer, size_t length) = 0;
+    };
+
+    /**
+    * Reads at explicit offsets through the read cursor of a TskFile. The seek
+    * and the reads that follow it are serialized, so concurrent callers 
+    * share the file's I/O but can process what they read in parallel.
+    */
+    class TskFilePositionalReader : public PositionalReader
+    {
+    public:
+        /**
+        * @param pFile The file to read. The reader leaves the file's read 
+        * cursor at an unspecified position.
+        */
+        explicit TskFilePositionalReader(TskFile *pFile);
+
+        virtual size_t readAt(uint64_t offset, char *buffer, size_t length);
+
+        /**
+        * @return The number of bytes read so far. 
+        */
+        uint64_t bytesRead() const;
+
+        /**
+        * @return The number of calls made to read the file so far.
+        */
+        uint64_t readCalls() const;
+
+        /**
+        * @return The microseconds spent reading so far, summed over all
+        * callers.
+        */
+        Poco::Timestamp::TimeDiff readTime() const;
+
+    private:
+        TskFile *m_pFile;
+        mutable Poco::FastMutex m_mutex;
+        uint64_t m_bytesRead;
+        uint64_t m_readCalls;
+        Poco::Timestamp::TimeDiff m_readTime;
+    };
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ReadBudget.cpp
+* Contains the implementation of a class that limits how much of a file is 
+* read and for how long.
+*/
+
+// Module includes
+#include "ReadBudget.h"
+
+// C/C++ library includes
+#include <algorithm>
+
+namespace EntropyModule
+{
+    ReadBudget::ReadBudget(uint64_t maxBytes, Poco::Timestamp::TimeDiff maxTime) :
+        m_maxBytes(maxBytes),
+        m_maxTime(maxTime),
+        m_bytes(0),
+        m_timedOut(false)
+    {
+    }
+
+    uint64_t ReadBudget::limit(uint64_t length)
+    {
+        if (m_timedOut || (m_maxTime > 0 && m_started.elapsed() >= m_maxTime))
+        {
+            m_timedOut = true;
+            return 0;
+        }
+
+        if (m_maxBytes > 0)
+        {
+            return m_bytes < m_maxBytes ? std::min(length, m_maxBytes - m_bytes) : 0;
+        }
+
+        return length;
+    }
+}
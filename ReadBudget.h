@@ -0,0 +1,100 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ReadBudget.h
+* Contains the interface of a class that limits how much of a file is read
+* and for how long.
+*/
+
+#ifndef _ENTROPY_READBUDGET_H
+#define _ENTROPY_READBUDGET_H
+
+// Poco includes
+#include "Poco/Timestamp.h"
+
+// C/C++ library includes
+#include <stdint.h>
+
+namespace EntropyModule
+{
+    /**
+    * Limits the bytes read from a file and the time spent reading it. Code 
+    * that reads a file asks the budget how much it may read before each 
+    * read and reports what it read, and stops once the budget allows 
+    * nothing more. A read already under way is not interrupted, so the time
+    * limit can be overrun by one read.
+    */
+    class ReadBudget
+    {
+    public:
+        /**
+        * Starts the clock.
+        *
+        * @param maxBytes The most bytes that may be read, or 0 for no limit.
+        * @param maxTime The most microseconds that may be spent, or 0 for no
+        * limit.
+        */
+        ReadBudget(uint64_t maxBytes, Poco::Timestamp::TimeDiff maxTime);
+
+        /**
+        * Limits the length of the next read to what is left of the budget.
+        * Once the time is up, no more reads are allowed.
+        *
+        * @param length The number of bytes the caller would like to read.
+        * @return The number of bytes the caller may read, 0 once the budget
+        * is spent.
+        */
+        uint64_t limit(uint64_t length);
+
+        /**
+        * Records bytes that were read.
+        *
+        * @param bytes The number of bytes.
+        */
+        void charge(uint64_t bytes) { m_bytes += bytes; }
+
+        /**
+        * @return Whether all of the bytes have been read or a read was 
+        * refused because the time was up. The content may still have been
+        * read in full if it ended at that point.
+        */
+        bool exhausted() const { return m_timedOut || (m_maxBytes > 0 && m_bytes >= m_maxBytes); }
+
+    private:
+        uint64_t m_maxBytes;
+        Poco::Timestamp::TimeDiff m_maxTime;
+        Poco::Timestamp m_started;
+        uint64_t m_bytes;
+        bool m_timedOut;
+    };
+}
+
+#endif
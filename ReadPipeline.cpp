@@ -0,0 +1,175 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ReadPipeline.cpp
+* Contains the implementation of a class that reads file content on a 
+* separate thread ahead of the code that consumes it.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ReadPipeline.h"
+
+// C/C++ library includes
+#include <assert.h>
+
+namespace EntropyModule
+{
+    // The free slot semaphore has room for one signal more than there are 
+    // slots, which the destructor uses to wake the reader thread.
+    ReadPipeline::ReadPipeline(TskFile *pFile, size_t bufferSize, size_t depth) :
+        m_pFile(pFile),
+        m_freeSlots(static_cast<int>(depth), static_cast<int>(depth) + 1),
+        m_filledSlots(0, static_cast<int>(depth)),
+        m_consumeIndex(0),
+        m_holding(false),
+        m_finished(false),
+        m_stopping(false)
+    {
+        assert(depth >= 2);
+
+        try
+        {
+            m_slots.reserve(depth);
+            for (size_t i = 0; i < depth; ++i)
+            {
+                Slot slot = { NULL, 0, false };
+                m_slots.push_back(slot);
+                m_slots.back().buffer = new AlignedBuffer(bufferSize);
+            }
+
+            m_thread.start(*this);
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < m_slots.size(); ++i)
+            {
+                delete m_slots[i].buffer;
+            }
+
+            throw;
+        }
+    }
+
+    ReadPipeline::~ReadPipeline()
+    {
+        m_stopping = true;
+        m_freeSlots.set();
+        m_thread.join();
+
+        for (size_t i = 0; i < m_slots.size(); ++i)
+        {
+            delete m_slots[i].buffer;
+        }
+    }
+
+    size_t ReadPipeline::next(const char *&data)
+    {
+        if (m_holding)
+        {
+            m_holding = false;
+            m_consumeIndex = (m_consumeIndex + 1) % m_slots.size();
+            m_freeSlots.set();
+        }
+
+        if (m_finished)
+        {
+            return 0;
+        }
+
+        m_filledSlots.wait();
+        const Slot &slot = m_slots[m_consumeIndex];
+        if (slot.failed)
+        {
+            m_finished = true;
+            throw TskException("read failed: " + m_error);
+        }
+
+        if (slot.length == 0)
+        {
+            m_finished = true;
+            return 0;
+        }
+
+        m_holding = true;
+        data = slot.buffer->data();
+        return slot.length;
+    }
+
+    void ReadPipeline::run()
+    {
+        size_t index = 0;
+        for (;;)
+        {
+            m_freeSlots.wait();
+            if (m_stopping)
+            {
+                break;
+            }
+
+            Slot &slot = m_slots[index];
+            ssize_t bytesRead = 0;
+            slot.failed = false;
+            try
+            {
+                bytesRead = m_pFile->read(slot.buffer->data(), slot.buffer->size());
+            }
+            catch (TskException &ex)
+            {
+                m_error = ex.message();
+                slot.failed = true;
+            }
+            catch (std::exception &ex)
+            {
+                m_error = ex.what();
+                slot.failed = true;
+            }
+            catch (...)
+            {
+                m_error = "unrecognized exception";
+                slot.failed = true;
+            }
+
+            // As with a sequential read loop, a negative result ends the file.
+            slot.length = bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+            m_filledSlots.set();
+
+            if (slot.length == 0)
+            {
+                break;
+            }
+
+            index = (index + 1) % m_slots.size();
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ReadPipeline.h
+* Contains the interface of a class that reads file content on a separate
+* thread ahead of the code that consumes it.
+*/
+
+#ifndef _ENTROPY_READPIPELINE_H
+#define _ENTROPY_READPIPELINE_H
+
+// Module includes
+#include "AlignedBuffer.h"
+
+// Poco includes
+#include "Poco/Runnable.h"
+#include "Poco/Semaphore.h"
+#include "Poco/Thread.h"
+
+// C/C++ library includes
+#include <string>
+#include <vector>
+
+class TskFile;
+
+namespace EntropyModule
+{
+    /**
+    * Reads a file sequentially on a reader thread into a ring of buffers, 
+    * so that reading the next buffers overlaps with processing the current
+    * one. Reading starts when the pipeline is constructed and stops at the 
+    * end of the file or when the pipeline is destroyed.
+    *
+    * The file must not be used by anyone else while the pipeline exists.
+    */
+    class ReadPipeline : private Poco::Runnable
+    {
+    public:
+        /**
+        * @param pFile The file to read, positioned where reading should 
+        * start.
+        * @param bufferSize The size of each buffer in the ring.
+        * @param depth The number of buffers in the ring, at least 2.
+        */
+        ReadPipeline(TskFile *pFile, size_t bufferSize, size_t depth);
+        ~ReadPipeline();
+
+        /**
+        * Waits for the next buffer of file content. The buffer remains valid 
+        * until the next call, when it is handed back to the reader thread.
+        *
+        * @param data Receives a pointer to the content.
+        * @return The number of bytes in the buffer, or 0 at the end of the
+        * file.
+        * @throws TskException if reading the file failed.
+        */
+        size_t next(const char *&data);
+
+    private:
+        struct Slot
+        {
+            AlignedBuffer *buffer;
+            size_t length;
+            bool failed;
+        };
+
+        // Not copyable.
+        ReadPipeline(const ReadPipeline&);
+        ReadPipeline &operator=(const ReadPipeline&);
+
+        // The body of the reader thread.
+        void run();
+
+        TskFile *m_pFile;
+        std::vector<Slot> m_slots;
+        Poco::Semaphore m_freeSlots;
+        Poco::Semaphore m_filledSlots;
+        Poco::Thread m_thread;
+        std::string m_error;
+        size_t m_consumeIndex;
+        bool m_holding;
+        bool m_finished;
+        bool m_stopping;
+    };
+}
+
+#endif
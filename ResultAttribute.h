@@ -0,0 +1,139 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ResultAttribute.h
+* Contains the definition of a blackboard attribute value computed by the
+* module, held until it is posted.
+*/
+
+#ifndef _ENTROPY_RESULTATTRIBUTE_H
+#define _ENTROPY_RESULTATTRIBUTE_H
+
+// C/C++ library includes
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace EntropyModule
+{
+    /**
+    * A value the module posts to the blackboard, together with the attribute
+    * type and context it is posted with. The constructors mirror those of
+    * TskBlackboardAttribute. Unlike a TskBlackboardAttribute, a result 
+    * attribute can be kept, for example by the result cache, and posted
+    * for any number of files.
+    */
+    struct ResultAttribute
+    {
+        enum ValueType
+        {
+            INTEGER,
+            LONG,
+            DOUBLE,
+            STRING,
+            BYTES
+        };
+
+        ResultAttribute() :
+            attributeType(0),
+            valueType(INTEGER),
+            intValue(0),
+            longValue(0),
+            doubleValue(0.0)
+        {
+        }
+
+        ResultAttribute(int type, const std::string &attributeContext, int value) :
+            attributeType(type),
+            context(attributeContext),
+            valueType(INTEGER),
+            intValue(value),
+            longValue(0),
+            doubleValue(0.0)
+        {
+        }
+
+        ResultAttribute(int type, const std::string &attributeContext, uint64_t value) :
+            attributeType(type),
+            context(attributeContext),
+            valueType(LONG),
+            intValue(0),
+            longValue(value),
+            doubleValue(0.0)
+        {
+        }
+
+        ResultAttribute(int type, const std::string &attributeContext, double value) :
+            attributeType(type),
+            context(attributeContext),
+            valueType(DOUBLE),
+            intValue(0),
+            longValue(0),
+            doubleValue(value)
+        {
+        }
+
+        ResultAttribute(int type, const std::string &attributeContext, const std::string &value) :
+            attributeType(type),
+            context(attributeContext),
+            valueType(STRING),
+            intValue(0),
+            longValue(0),
+            doubleValue(0.0),
+            stringValue(value)
+        {
+        }
+
+        ResultAttribute(int type, const std::string &attributeContext, const std::vector<unsigned char> &value) :
+            attributeType(type),
+            context(attributeContext),
+            valueType(BYTES),
+            intValue(0),
+            longValue(0),
+            doubleValue(0.0),
+            bytesValue(value)
+        {
+        }
+
+        int attributeType;
+        std::string context;
+        ValueType valueType;
+        int intValue;
+        uint64_t longValue;
+        double doubleValue;
+        std::string stringValue;
+        std::vector<unsigned char> bytesValue;
+    };
+
+    typedef std::vector<ResultAttribute> ResultAttributes;
+}
+
+#endif
@@ -0,0 +1,338 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ResultCache.cpp
+* Contains the implementation of a class that remembers the results computed
+* for file content with a known hash.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ResultCache.h"
+
+// Poco includes
+#include "Poco/BinaryReader.h"
+#include "Poco/BinaryWriter.h"
+#include "Poco/File.h"
+
+// C/C++ library includes
+#include <fstream>
+#include <new>
+#include <set>
+
+namespace
+{
+    const char STORE_MAGIC[] = "ENTCACHE";
+    const Poco::UInt32 STORE_VERSION = 1;
+
+    // The module posts a few dozen attributes for a file at most, so an 
+    // entry with more can only come from a corrupt store.
+    const Poco::UInt32 MAX_ENTRY_ATTRIBUTES = 256;
+
+    /**
+    * @return The number of bytes left in a stream of a file of a known size.
+    */
+    Poco::UInt64 bytesLeft(std::istream &stream, Poco::UInt64 fileSize)
+    {
+        std::streamoff position = stream.tellg();
+        if (position < 0 || static_cast<Poco::UInt64>(position) > fileSize)
+        {
+            return 0;
+        }
+
+        return fileSize - static_cast<Poco::UInt64>(position);
+    }
+
+    /**
+    * @return The recorded hash of a file, or an empty string if there is 
+    * none.
+    */
+    std::string getFileHash(TskFile *pFile, TskImgDB::HASH_TYPE hashType)
+    {
+        try
+        {
+            return pFile->getHash(hashType);
+        }
+        catch (...)
+        {
+            return std::string();
+        }
+    }
+
+    void writeAttribute(Poco::BinaryWriter &writer, const EntropyModule::ResultAttribute &attribute)
+    {
+        writer << attribute.attributeType << attribute.context << static_cast<int>(attribute.valueType);
+        switch (attribute.valueType)
+        {
+        case EntropyModule::ResultAttribute::INTEGER:
+            writer << attribute.intValue;
+            break;
+        case EntropyModule::ResultAttribute::LONG:
+            writer << static_cast<Poco::UInt64>(attribute.longValue);
+            break;
+        case EntropyModule::ResultAttribute::DOUBLE:
+            writer << attribute.doubleValue;
+            break;
+        case EntropyModule::ResultAttribute::STRING:
+            writer << attribute.stringValue;
+            break;
+        case EntropyModule::ResultAttribute::BYTES:
+            writer << static_cast<Poco::UInt32>(attribute.bytesValue.size());
+            if (!attribute.bytesValue.empty())
+            {
+                writer.writeRaw(reinterpret_cast<const char*>(&attribute.bytesValue[0]), attribute.bytesValue.size());
+            }
+            break;
+        }
+    }
+
+    /**
+    * Reads an attribute written by writeAttribute(). 
+    *
+    * @return False if the attribute is corrupt, including when its value 
+    * would run past the end of the store file.
+    */
+    bool readAttribute(Poco::BinaryReader &reader, std::istream &stream, Poco::UInt64 fileSize, EntropyModule::ResultAttribute &attribute)
+    {
+        int valueType = 0;
+        reader >> attribute.attributeType >> attribute.context >> valueType;
+        attribute.valueType = static_cast<EntropyModule::ResultAttribute::ValueType>(valueType);
+        switch (attribute.valueType)
+        {
+        case EntropyModule::ResultAttribute::INTEGER:
+            reader >> attribute.intValue;
+            break;
+        case EntropyModule::ResultAttribute::LONG:
+            {
+                Poco::UInt64 value = 0;
+                reader >> value;
+                attribute.longValue = value;
+            }
+            break;
+        case EntropyModule::ResultAttribute::DOUBLE:
+            reader >> attribute.doubleValue;
+            break;
+        case EntropyModule::ResultAttribute::STRING:
+            reader >> attribute.stringValue;
+            break;
+        case EntropyModule::ResultAttribute::BYTES:
+            {
+                Poco::UInt32 size = 0;
+                reader >> size;
+                if (!reader.good() || size > bytesLeft(stream, fileSize))
+                {
+                    return false;
+                }
+
+                std::string bytes;
+                reader.readRaw(size, bytes);
+                attribute.bytesValue.assign(bytes.begin(), bytes.end());
+            }
+            break;
+        default:
+            return false;
+        }
+
+        return reader.good();
+    }
+}
+
+namespace EntropyModule
+{
+    ResultCache::ResultCache(size_t capacity, const std::string &storePath) :
+        m_cache(static_cast<long>(capacity)),
+        m_storePath(storePath)
+    {
+    }
+
+    std::string ResultCache::contentHash(TskFile *pFile)
+    {
+        std::string hash = getFileHash(pFile, TskImgDB::MD5);
+        if (!hash.empty())
+        {
+            return "md5:" + hash;
+        }
+
+        hash = getFileHash(pFile, TskImgDB::SHA1);
+        if (!hash.empty())
+        {
+            return "sha1:" + hash;
+        }
+
+        return std::string();
+    }
+
+    std::string ResultCache::makeKey(TskFile *pFile, const std::string &signature)
+    {
+        std::string hash = contentHash(pFile);
+        if (hash.empty())
+        {
+            return std::string();
+        }
+
+        return hash + "|" + signature;
+    }
+
+    bool ResultCache::find(const std::string &key, ResultAttributes &attributes)
+    {
+        Poco::SharedPtr<ResultAttributes> entry = m_cache.get(key);
+        if (entry.isNull())
+        {
+            return false;
+        }
+
+        attributes = *entry;
+        return true;
+    }
+
+    void ResultCache::add(const std::string &key, const ResultAttributes &attributes)
+    {
+        m_cache.add(key, attributes);
+    }
+
+    bool ResultCache::load()
+    {
+        if (m_storePath.empty() || !Poco::File(m_storePath).exists())
+        {
+            return true;
+        }
+
+        std::ifstream stream(m_storePath.c_str(), std::ios::in | std::ios::binary);
+        if (!stream)
+        {
+            throw TskException("cannot open result cache " + m_storePath);
+        }
+
+        // Counts and lengths read from the file are checked before anything
+        // is allocated for them, and a store that fails a check is dropped 
+        // as a whole rather than trusted in part.
+        Poco::UInt64 fileSize = Poco::File(m_storePath).getSize();
+        Poco::BinaryReader reader(stream, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+        std::string magic;
+        Poco::UInt32 version = 0;
+        Poco::UInt32 entryCount = 0;
+        reader.readRaw(sizeof(STORE_MAGIC) - 1, magic);
+        reader >> version >> entryCount;
+        bool valid = reader.good() && magic == STORE_MAGIC && version == STORE_VERSION;
+        try
+        {
+            for (Poco::UInt32 i = 0; valid && i < entryCount; ++i)
+            {
+                std::string key;
+                Poco::UInt32 attributeCount = 0;
+                reader >> key >> attributeCount;
+                if (!reader.good() || attributeCount > MAX_ENTRY_ATTRIBUTES)
+                {
+                    valid = false;
+                    break;
+                }
+
+                ResultAttributes attributes;
+                attributes.reserve(attributeCount);
+                for (Poco::UInt32 j = 0; valid && j < attributeCount; ++j)
+                {
+                    attributes.push_back(ResultAttribute());
+                    valid = readAttribute(reader, stream, fileSize, attributes.back());
+                }
+
+                if (valid)
+                {
+                    m_cache.add(key, attributes);
+                }
+            }
+        }
+        catch (std::bad_alloc &)
+        {
+            // A corrupt string length can still ask for too much memory.
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            m_cache.clear();
+        }
+
+        return valid;
+    }
+
+    void ResultCache::save()
+    {
+        if (m_storePath.empty())
+        {
+            return;
+        }
+
+        // Write a new file and swap it in, so a failed save leaves the old 
+        // store intact.
+        std::string tempPath = m_storePath + ".tmp";
+        {
+            std::ofstream stream(tempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!stream)
+            {
+                throw TskException("cannot create result cache " + tempPath);
+            }
+
+            std::set<std::string> keys = m_cache.getAllKeys();
+            std::vector<std::pair<std::string, Poco::SharedPtr<ResultAttributes> > > entries;
+            for (std::set<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+            {
+                Poco::SharedPtr<ResultAttributes> entry = m_cache.get(*it);
+                if (!entry.isNull())
+                {
+                    entries.push_back(std::make_pair(*it, entry));
+                }
+            }
+
+            Poco::BinaryWriter writer(stream, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+            writer.writeRaw(STORE_MAGIC, sizeof(STORE_MAGIC) - 1);
+            writer << STORE_VERSION << static_cast<Poco::UInt32>(entries.size());
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                const ResultAttributes &attributes = *entries[i].second;
+                writer << entries[i].first << static_cast<Poco::UInt32>(attributes.size());
+                for (size_t j = 0; j < attributes.size(); ++j)
+                {
+                    writeAttribute(writer, attributes[j]);
+                }
+            }
+
+            writer.flush();
+            if (!stream)
+            {
+                throw TskException("cannot write result cache " + tempPath);
+            }
+        }
+
+        Poco::File(tempPath).renameTo(m_storePath);
+    }
+}
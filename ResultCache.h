@@ -0,0 +1,132 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ResultCache.h
+* Contains the interface of a class that remembers the results computed for
+* file content with a known hash.
+*/
+
+#ifndef _ENTROPY_RESULTCACHE_H
+#define _ENTROPY_RESULTCACHE_H
+
+// Module includes
+#include "ResultAttribute.h"
+
+// Poco includes
+#include "Poco/LRUCache.h"
+
+// C/C++ library includes
+#include <string>
+
+class TskFile;
+
+namespace EntropyModule
+{
+    /**
+    * Remembers the attributes posted for files, keyed by a hash of the 
+    * file's content that an earlier module in the pipeline put on the 
+    * blackboard, so duplicate files need not be read again. The cache holds 
+    * a bounded number of entries and evicts the least recently used one 
+    * when it is full. It can be saved to and loaded from a file, so results
+    * carry over between pipeline runs. The cache is safe to use from 
+    * several threads.
+    */
+    class ResultCache
+    {
+    public:
+        /**
+        * @param capacity The maximum number of entries.
+        * @param storePath The file the cache is loaded from and saved to, or
+        * an empty string to keep the cache in memory only.
+        */
+        ResultCache(size_t capacity, const std::string &storePath);
+
+        /**
+        * Names a file's content by the MD5 or, failing that, the SHA-1 hash
+        * recorded for it.
+        *
+        * @param pFile The file.
+        * @return The name of the hash, a colon and the hash, or an empty 
+        * string if no hash is recorded.
+        */
+        static std::string contentHash(TskFile *pFile);
+
+        /**
+        * Builds the cache key of a file from its content hash. 
+        *
+        * @param pFile The file.
+        * @param signature Identifies the settings that affect the results, so
+        * results computed with other settings are not reused.
+        * @return The key, or an empty string if no hash is recorded.
+        */
+        static std::string makeKey(TskFile *pFile, const std::string &signature);
+
+        /**
+        * Looks up the attributes posted for a key.
+        *
+        * @param key The key.
+        * @param attributes Receives the attributes if the key is found.
+        * @return True if the key was found.
+        */
+        bool find(const std::string &key, ResultAttributes &attributes);
+
+        /**
+        * Remembers the attributes posted for a key.
+        *
+        * @param key The key.
+        * @param attributes The attributes.
+        */
+        void add(const std::string &key, const ResultAttributes &attributes);
+
+        /**
+        * Loads the entries saved in the store file, if it exists. A store
+        * file that is corrupt or of another format is discarded: none of 
+        * its entries are loaded, and the next save() replaces it.
+        *
+        * @return False if the store file was discarded.
+        * @throws TskException if the store file cannot be opened.
+        */
+        bool load();
+
+        /**
+        * Saves the entries to the store file, replacing its content.
+        *
+        * @throws TskException if the store file cannot be written.
+        */
+        void save();
+
+    private:
+        Poco::LRUCache<std::string, ResultAttributes> m_cache;
+        std::string m_storePath;
+    };
+}
+
+#endif
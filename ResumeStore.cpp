@@ -0,0 +1,342 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ResumeStore.cpp
+* Contains the implementation of a class that remembers how far into a file
+* its bytes have been counted, so a later run can count only what was 
+* appended.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ResumeStore.h"
+#include "AlignedBuffer.h"
+#include "PositionalReader.h"
+
+// Poco includes
+#include "Poco/BinaryReader.h"
+#include "Poco/BinaryWriter.h"
+#include "Poco/File.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <set>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    const char STORE_MAGIC[] = "ENTRESUM";
+    const Poco::UInt32 STORE_VERSION = 3;
+
+    // The primes of XXH64, whose round and final mix the hash uses.
+    const uint64_t PRIME_1 = 11400714785074694791ULL;
+    const uint64_t PRIME_2 = 14029467366897019727ULL;
+    const uint64_t PRIME_3 = 1609587929392839161ULL;
+
+    /**
+    * Folds an 8-byte word into the hash.
+    */
+    inline uint64_t hashWord(uint64_t hash, uint64_t word)
+    {
+        hash += word * PRIME_2;
+        hash = (hash << 31) | (hash >> 33);
+        return hash * PRIME_1;
+    }
+}
+
+namespace EntropyModule
+{
+    PrefixHash::PrefixHash() :
+        m_hash(PRIME_3),
+        m_length(0),
+        m_word(0)
+    {
+    }
+
+    void PrefixHash::add(const uint8_t *data, size_t length)
+    {
+        // Bytes are gathered into little-endian words, so the hash does not
+        // depend on how the content was split into pieces.
+        const uint8_t *end = data + length;
+        while (data < end && (m_length % 8) != 0)
+        {
+            m_word |= static_cast<uint64_t>(*data++) << (8 * (m_length % 8));
+            if ((++m_length % 8) == 0)
+            {
+                m_hash = hashWord(m_hash, m_word);
+                m_word = 0;
+            }
+        }
+
+        while (end - data >= 8)
+        {
+            uint64_t word = 0;
+            for (int i = 7; i >= 0; --i)
+            {
+                word = (word << 8) | data[i];
+            }
+
+            m_hash = hashWord(m_hash, word);
+            data += 8;
+            m_length += 8;
+        }
+
+        while (data < end)
+        {
+            m_word |= static_cast<uint64_t>(*data++) << (8 * (m_length % 8));
+            ++m_length;
+        }
+    }
+
+    uint64_t PrefixHash::value() const
+    {
+        uint64_t hash = hashWord(m_hash, m_word) ^ m_length;
+        hash ^= hash >> 33;
+        hash *= PRIME_2;
+        hash ^= hash >> 29;
+        hash *= PRIME_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    ResumePoint::ResumePoint() :
+        offset(0),
+        fingerprint(0),
+        modified(0)
+    {
+        memset(counts, 0, sizeof(counts));
+    }
+
+    ResumeStore::ResumeStore(size_t capacity, const std::string &storePath) :
+        m_points(static_cast<long>(capacity)),
+        m_storePath(storePath)
+    {
+    }
+
+    std::string ResumeStore::makeKey(TskFile *pFile)
+    {
+        return pFile->getFullPath();
+    }
+
+    uint64_t ResumeStore::fingerprint(PositionalReader &reader, uint64_t length, AlignedBuffer &buffer, PrefixHash &hash)
+    {
+        hash = PrefixHash();
+        for (uint64_t offset = 0; offset < length; )
+        {
+            size_t size = static_cast<size_t>(std::min<uint64_t>(buffer.size(), length - offset));
+            size_t bytesRead = reader.readAt(offset, buffer.data(), size);
+            if (bytesRead == 0)
+            {
+                throw TskException("file is shorter than the fingerprinted length");
+            }
+
+            hash.add(reinterpret_cast<const uint8_t*>(buffer.data()), bytesRead);
+            offset += bytesRead;
+        }
+
+        return hash.value();
+    }
+
+    bool ResumeStore::isCandidate(const ResumePoint &point, uint64_t size, int64_t modified)
+    {
+        if (point.offset == 0 || point.offset > size)
+        {
+            return false;
+        }
+
+        // A file given an earlier time than when its counts were taken has
+        // been replaced, for example restored from a backup.
+        return point.modified == 0 || modified == 0 || modified >= point.modified;
+    }
+
+    bool ResumeStore::find(const std::string &key, ResumePoint &point)
+    {
+        Poco::SharedPtr<ResumePoint> entry = m_points.get(key);
+        if (entry.isNull())
+        {
+            return false;
+        }
+
+        point = *entry;
+        return true;
+    }
+
+    void ResumeStore::add(const std::string &key, const ResumePoint &point)
+    {
+        m_points.add(key, point);
+    }
+
+    bool ResumeStore::load()
+    {
+        if (m_storePath.empty() || !Poco::File(m_storePath).exists())
+        {
+            return true;
+        }
+
+        std::ifstream stream(m_storePath.c_str(), std::ios::in | std::ios::binary);
+        if (!stream)
+        {
+            throw TskException("cannot open resume store " + m_storePath);
+        }
+
+        // A store that fails a check, such as one left half written by a 
+        // crash, is dropped as a whole rather than trusted in part.
+        Poco::BinaryReader reader(stream, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+        std::string magic;
+        Poco::UInt32 version = 0;
+        Poco::UInt32 pointCount = 0;
+        reader.readRaw(sizeof(STORE_MAGIC) - 1, magic);
+        reader >> version >> pointCount;
+        bool valid = reader.good() && magic == STORE_MAGIC && version > 0 && version <= STORE_VERSION;
+        if (valid && version < STORE_VERSION)
+        {
+            return true;
+        }
+
+        try
+        {
+            for (Poco::UInt32 i = 0; valid && i < pointCount; ++i)
+            {
+                std::string key;
+                ResumePoint point;
+                Poco::UInt64 offset = 0;
+                Poco::UInt64 fingerprint = 0;
+                Poco::Int64 modified = 0;
+                Poco::UInt16 binCount = 0;
+                reader >> key >> offset >> fingerprint >> modified >> binCount;
+                point.offset = offset;
+                point.fingerprint = fingerprint;
+                point.modified = modified;
+
+                // Only the bins that are not empty are stored, and their 
+                // counts add up to the offset.
+                uint64_t total = 0;
+                valid = reader.good() && binCount <= 256;
+                for (Poco::UInt16 j = 0; valid && j < binCount; ++j)
+                {
+                    Poco::UInt8 value = 0;
+                    Poco::UInt64 count = 0;
+                    reader >> value >> count;
+                    valid = reader.good() && point.counts[value] == 0 && count > 0 && count <= offset - total;
+                    point.counts[value] = count;
+                    total += count;
+                }
+
+                if (valid && total == offset)
+                {
+                    m_points.add(key, point);
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+        }
+        catch (std::bad_alloc &)
+        {
+            // A corrupt key length can still ask for too much memory.
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            m_points.clear();
+        }
+
+        return valid;
+    }
+
+    void ResumeStore::save()
+    {
+        if (m_storePath.empty())
+        {
+            return;
+        }
+
+        // Write a new file and swap it in, so a failed save leaves the old 
+        // store intact.
+        std::string tempPath = m_storePath + ".tmp";
+        {
+            std::ofstream stream(tempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!stream)
+            {
+                throw TskException("cannot create resume store " + tempPath);
+            }
+
+            std::set<std::string> keys = m_points.getAllKeys();
+            std::vector<std::pair<std::string, Poco::SharedPtr<ResumePoint> > > entries;
+            for (std::set<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+            {
+                Poco::SharedPtr<ResumePoint> entry = m_points.get(*it);
+                if (!entry.isNull())
+                {
+                    entries.push_back(std::make_pair(*it, entry));
+                }
+            }
+
+            Poco::BinaryWriter writer(stream, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+            writer.writeRaw(STORE_MAGIC, sizeof(STORE_MAGIC) - 1);
+            writer << STORE_VERSION << static_cast<Poco::UInt32>(entries.size());
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                const ResumePoint &point = *entries[i].second;
+                Poco::UInt16 binCount = 0;
+                for (int value = 0; value < 256; ++value)
+                {
+                    binCount += point.counts[value] != 0;
+                }
+
+                writer << entries[i].first << static_cast<Poco::UInt64>(point.offset) << static_cast<Poco::UInt64>(point.fingerprint) 
+                    << static_cast<Poco::Int64>(point.modified) << binCount;
+                for (int value = 0; value < 256; ++value)
+                {
+                    if (point.counts[value] != 0)
+                    {
+                        writer << static_cast<Poco::UInt8>(value) << static_cast<Poco::UInt64>(point.counts[value]);
+                    }
+                }
+            }
+
+            writer.flush();
+            if (!stream)
+            {
+                throw TskException("cannot write resume store " + tempPath);
+            }
+        }
+
+        Poco::File(tempPath).renameTo(m_storePath);
+    }
+}
@@ -0,0 +1,211 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ResumeStore.h
+* Contains the interface of a class that remembers how far into a file its
+* bytes have been counted, so a later run can count only what was appended.
+*/
+
+#ifndef _ENTROPY_RESUMESTORE_H
+#define _ENTROPY_RESUMESTORE_H
+
+// Poco includes
+#include "Poco/LRUCache.h"
+
+// C/C++ library includes
+#include <stdint.h>
+#include <string>
+
+class TskFile;
+
+namespace EntropyModule
+{
+    class AlignedBuffer;
+    class PositionalReader;
+
+    /**
+    * Hashes the content of a file as it is read, for the fingerprint of a 
+    * resume point. Bytes can be added in pieces of any length; the hash 
+    * depends only on the bytes and their number. It is a 64-bit 
+    * non-cryptographic hash: an accidental change to the content is missed
+    * with a chance of about 2^-64, but a deliberate collision can be made.
+    */
+    class PrefixHash
+    {
+    public:
+        PrefixHash();
+
+        /**
+        * Adds bytes to the hash.
+        *
+        * @param data The bytes.
+        * @param length The number of bytes.
+        */
+        void add(const uint8_t *data, size_t length);
+
+        /**
+        * @return The hash of the bytes added so far.
+        */
+        uint64_t value() const;
+
+    private:
+        uint64_t m_hash;
+        uint64_t m_length;
+        uint64_t m_word;
+    };
+
+    /**
+    * The byte counts of the first offset bytes of a file, together with a 
+    * fingerprint of those bytes and the file's modification time when the
+    * counts were taken, in seconds since the epoch, or 0 if it was not 
+    * known.
+    */
+    struct ResumePoint
+    {
+        ResumePoint();
+
+        uint64_t offset;
+        uint64_t fingerprint;
+        int64_t modified;
+        uint64_t counts[256];
+    };
+
+    /**
+    * Remembers the byte counts of files by path, so that when a file is 
+    * analyzed again after data has been appended to it only the new data 
+    * needs to be counted. A stored point is only used if the file has not 
+    * been given an earlier modification time and the PrefixHash of all of 
+    * the file's first offset bytes still matches, so counts are resumed 
+    * only for a prefix that is unchanged but for a hash collision. Checking
+    * the hash costs one sequential read of the prefix; only the counting 
+    * of it is saved. The store holds a bounded 
+    * number of points and evicts the least recently used one when it is 
+    * full. It can be saved to and loaded from a file, so points carry over
+    * between pipeline runs. The store is safe to use from several threads.
+    */
+    class ResumeStore
+    {
+    public:
+        /**
+        * Files of at most this many bytes are fingerprinted in full, which 
+        * costs as much as counting them, so no points are kept for them.
+        */
+        enum { MIN_FILE_SIZE = 64 * 1024 };
+
+        /**
+        * @param capacity The maximum number of points.
+        * @param storePath The file the store is loaded from and saved to, or
+        * an empty string to keep the store in memory only.
+        */
+        ResumeStore(size_t capacity, const std::string &storePath);
+
+        /**
+        * Builds the key of a file from its full path.
+        *
+        * @param pFile The file.
+        * @return The key, or an empty string if the file has no path.
+        */
+        static std::string makeKey(TskFile *pFile);
+
+        /**
+        * Computes the fingerprint of the first length bytes of a file, 
+        * reading them in order.
+        *
+        * @param reader Reads the file.
+        * @param length The number of bytes to fingerprint.
+        * @param buffer The buffer the bytes are read into, in pieces of
+        * its size.
+        * @param hash Receives the hash of the bytes, so that bytes read 
+        * after them can be added to it.
+        * @return The fingerprint, the value of the hash.
+        * @throws TskException if the file cannot be read or has fewer than
+        * length bytes.
+        */
+        static uint64_t fingerprint(PositionalReader &reader, uint64_t length, AlignedBuffer &buffer, PrefixHash &hash);
+
+        /**
+        * Decides whether a point can be resumed from, given what the file 
+        * system reports about the file now. The fingerprint still has to be 
+        * checked.
+        *
+        * @param point The stored point.
+        * @param size The file's size.
+        * @param modified The file's modification time in seconds since the 
+        * epoch, or 0 if it is not known.
+        * @return False if the file is now shorter than the stored point or 
+        * was modified before the point was taken.
+        */
+        static bool isCandidate(const ResumePoint &point, uint64_t size, int64_t modified);
+
+        /**
+        * Looks up the point stored for a key.
+        *
+        * @param key The key.
+        * @param point Receives the point if the key is found.
+        * @return True if the key was found.
+        */
+        bool find(const std::string &key, ResumePoint &point);
+
+        /**
+        * Remembers the point reached for a key.
+        *
+        * @param key The key.
+        * @param point The point.
+        */
+        void add(const std::string &key, const ResumePoint &point);
+
+        /**
+        * Loads the points saved in the store file, if it exists. A store 
+        * saved by an earlier version of the module is ignored, since its
+        * fingerprints are computed differently. A store file that is 
+        * truncated or corrupt, or has a point whose counts do not add up 
+        * to its offset, is discarded: none of its points are loaded, and 
+        * the next save() replaces it.
+        *
+        * @return False if the store file was discarded.
+        * @throws TskException if the store file cannot be opened.
+        */
+        bool load();
+
+        /**
+        * Saves the points to the store file, replacing its content.
+        *
+        * @throws TskException if the store file cannot be written.
+        */
+        void save();
+
+    private:
+        Poco::LRUCache<std::string, ResumePoint> m_points;
+        std::string m_storePath;
+    };
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file RunStatistics.cpp
+* Contains the implementation of the classes that measure where the module
+* spends its time over a pipeline run.
+*/
+
+// Module includes
+#include "RunStatistics.h"
+
+// C/C++ library includes
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    const char *MODE_NAMES[EntropyModule::FileStatistics::MODE_COUNT] = 
+    {
+        "small",
+        "sequential",
+        "read-ahead",
+        "mapped",
+        "chunked",
+        "gpu",
+        "streamed",
+        "sampled",
+        "cached",
+        "resumed",
+        "skipped"
+    };
+
+    double toSeconds(Poco::Timestamp::TimeDiff microseconds)
+    {
+        return static_cast<double>(microseconds) / 1000000.0;
+    }
+
+    /**
+    * @return pow(2, bucket), the upper bound in microseconds of a latency 
+    * bucket.
+    */
+    Poco::Timestamp::TimeDiff bucketLimit(int bucket)
+    {
+        return static_cast<Poco::Timestamp::TimeDiff>(1) << bucket;
+    }
+}
+
+namespace EntropyModule
+{
+    FileStatistics::FileStatistics() :
+        mode(SEQUENTIAL),
+        bytesRead(0),
+        readCalls(0),
+        holeBytes(0),
+        readTime(0),
+        countTime(0),
+        reduceTime(0)
+    {
+    }
+
+    void RunStatistics::Totals::clear()
+    {
+        started.update();
+        files = 0;
+        failures = 0;
+        for (int i = 0; i < FileStatistics::MODE_COUNT; ++i)
+        {
+            modeFiles[i] = 0;
+        }
+
+        bytesRead = 0;
+        readCalls = 0;
+        holeBytes = 0;
+        readTime = 0;
+        countTime = 0;
+        reduceTime = 0;
+        for (int i = 0; i < LATENCY_BUCKETS; ++i)
+        {
+            latencies[i] = 0;
+        }
+    }
+
+    void RunStatistics::Totals::add(const Totals &other)
+    {
+        if (other.started < started)
+        {
+            started = other.started;
+        }
+
+        files += other.files;
+        failures += other.failures;
+        for (int i = 0; i < FileStatistics::MODE_COUNT; ++i)
+        {
+            modeFiles[i] += other.modeFiles[i];
+        }
+
+        bytesRead += other.bytesRead;
+        readCalls += other.readCalls;
+        holeBytes += other.holeBytes;
+        readTime += other.readTime;
+        countTime += other.countTime;
+        reduceTime += other.reduceTime;
+        for (int i = 0; i < LATENCY_BUCKETS; ++i)
+        {
+            latencies[i] += other.latencies[i];
+        }
+    }
+
+    Poco::Timestamp::TimeDiff RunStatistics::Totals::latencyPercentile(double percentile) const
+    {
+        uint64_t rank = static_cast<uint64_t>(percentile * static_cast<double>(files));
+        uint64_t seen = 0;
+        for (int i = 0; i < LATENCY_BUCKETS; ++i)
+        {
+            seen += latencies[i];
+            if (seen > rank)
+            {
+                return bucketLimit(i);
+            }
+        }
+
+        return bucketLimit(LATENCY_BUCKETS - 1);
+    }
+
+    RunStatistics::RunStatistics()
+    {
+        m_totals.clear();
+    }
+
+    void RunStatistics::clear()
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        m_totals.clear();
+    }
+
+    void RunStatistics::addFile(const FileStatistics &file, Poco::Timestamp::TimeDiff latency)
+    {
+        int bucket = 0;
+        while (bucket < LATENCY_BUCKETS - 1 && latency >= bucketLimit(bucket))
+        {
+            ++bucket;
+        }
+
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+
+        ++m_totals.files;
+        ++m_totals.modeFiles[file.mode];
+        m_totals.bytesRead += file.bytesRead;
+        m_totals.readCalls += file.readCalls;
+        m_totals.holeBytes += file.holeBytes;
+        m_totals.readTime += file.readTime;
+        m_totals.countTime += file.countTime;
+        m_totals.reduceTime += file.reduceTime;
+        ++m_totals.latencies[bucket];
+    }
+
+    void RunStatistics::addFailure()
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        ++m_totals.failures;
+    }
+
+    void RunStatistics::add(const RunStatistics &other)
+    {
+        // Copy the other totals first, so the two locks are never held
+        // together.
+        Totals totals;
+        {
+            Poco::FastMutex::ScopedLock lock(other.m_mutex);
+            totals = other.m_totals;
+        }
+
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        m_totals.add(totals);
+    }
+
+    std::vector<std::string> RunStatistics::summary() const
+    {
+        Totals totals;
+        {
+            Poco::FastMutex::ScopedLock lock(m_mutex);
+            totals = m_totals;
+        }
+
+        std::vector<std::string> lines;
+        double elapsed = toSeconds(totals.started.elapsed());
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1);
+        line << totals.files << " files analyzed, " << totals.failures << " failed, " << totals.bytesRead << " bytes read in " 
+            << totals.readCalls << " calls, " << totals.holeBytes << " bytes of holes skipped, over " << elapsed << " s";
+        if (elapsed > 0.0)
+        {
+            line << " (" << totals.bytesRead / elapsed / (1024.0 * 1024.0) << " MB/s, " << totals.files / elapsed << " files/s)";
+        }
+
+        lines.push_back(line.str());
+
+        line.str("");
+        line << "files by mode:";
+        for (int i = 0; i < FileStatistics::MODE_COUNT; ++i)
+        {
+            line << " " << MODE_NAMES[i] << " " << totals.modeFiles[i];
+        }
+
+        lines.push_back(line.str());
+
+        line.str("");
+        line << std::setprecision(3) << "time in reads " << toSeconds(totals.readTime) << " s, counting " << toSeconds(totals.countTime) 
+            << " s, reduction " << toSeconds(totals.reduceTime) << " s";
+        lines.push_back(line.str());
+
+        if (totals.files > 0)
+        {
+            line.str("");
+            line << "file latency p50 < " << totals.latencyPercentile(0.5) << " us, p99 < " << totals.latencyPercentile(0.99) << " us";
+            lines.push_back(line.str());
+
+            line.str("");
+            line << "file latency histogram:";
+            for (int i = 0; i < LATENCY_BUCKETS; ++i)
+            {
+                if (totals.latencies[i] > 0)
+                {
+                    line << " <" << bucketLimit(i) << "us " << totals.latencies[i];
+                }
+            }
+
+            lines.push_back(line.str());
+        }
+
+        return lines;
+    }
+}
@@ -0,0 +1,188 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file RunStatistics.h
+* Contains the interface of the classes that measure where the module spends
+* its time over a pipeline run.
+*/
+
+#ifndef _ENTROPY_RUNSTATISTICS_H
+#define _ENTROPY_RUNSTATISTICS_H
+
+// Poco includes
+#include "Poco/Mutex.h"
+#include "Poco/Timestamp.h"
+
+// C/C++ library includes
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace EntropyModule
+{
+    /**
+    * The work done for one file. It is filled in by the thread analyzing
+    * the file without any locking and added to the run statistics when the
+    * file is done.
+    */
+    struct FileStatistics
+    {
+        /**
+        * The ways a file can be handled.
+        */
+        enum Mode
+        {
+            SMALL_FILE,
+            SEQUENTIAL,
+            READ_AHEAD,
+            MAPPED,
+            CHUNKED,
+            GPU,
+            STREAMED,
+            SAMPLED,
+            CACHED,
+            RESUMED,
+            SKIPPED,
+            MODE_COUNT
+        };
+
+        FileStatistics();
+
+        Mode mode;
+        uint64_t bytesRead;
+        uint64_t readCalls;
+
+        /**
+        * Bytes of holes in sparse files, counted without being read.
+        */
+        uint64_t holeBytes;
+
+        /**
+        * Microseconds spent reading, or waiting for a reader thread. For
+        * chunked and sampled files, the sum over all threads of the time 
+        * spent in reads.
+        */
+        Poco::Timestamp::TimeDiff readTime;
+
+        /**
+        * Microseconds spent counting bytes and analyzing content.
+        */
+        Poco::Timestamp::TimeDiff countTime;
+
+        /**
+        * Microseconds spent reducing counts to results.
+        */
+        Poco::Timestamp::TimeDiff reduceTime;
+    };
+
+    /**
+    * Totals the work done for the files of a pipeline run and keeps a 
+    * histogram of the time taken per file. Each thread keeps statistics of
+    * its own, which are totaled when they are reported. Files are added 
+    * under a lock, once per file, but since only the reporting thread ever
+    * takes another thread's lock, the lock is uncontended.
+    */
+    class RunStatistics
+    {
+    public:
+        RunStatistics();
+
+        /**
+        * Adds a file that was analyzed successfully.
+        *
+        * @param file The work done for the file.
+        * @param latency Microseconds taken to analyze the file.
+        */
+        void addFile(const FileStatistics &file, Poco::Timestamp::TimeDiff latency);
+
+        /**
+        * Adds a file that could not be analyzed.
+        */
+        void addFailure();
+
+        /**
+        * Adds the files of other statistics. The run is taken to have 
+        * started when the earlier of the two did.
+        *
+        * @param other The statistics to add.
+        */
+        void add(const RunStatistics &other);
+
+        /**
+        * Forgets all files and restarts the clock.
+        */
+        void clear();
+
+        /**
+        * Summarizes the run so far.
+        *
+        * @return Lines of text, ready to be logged.
+        */
+        std::vector<std::string> summary() const;
+
+    private:
+        // Bucket 0 holds latencies below 1 microsecond, bucket i those of 
+        // at least 2^(i - 1) and below 2^i microseconds. The last bucket 
+        // holds the rest.
+        enum { LATENCY_BUCKETS = 40 };
+
+        struct Totals
+        {
+            void clear();
+            void add(const Totals &other);
+
+            // Finds the bucket containing a percentile of the latencies and
+            // returns the bucket's upper bound.
+            Poco::Timestamp::TimeDiff latencyPercentile(double percentile) const;
+
+            Poco::Timestamp started;
+            uint64_t files;
+            uint64_t failures;
+            uint64_t modeFiles[FileStatistics::MODE_COUNT];
+            uint64_t bytesRead;
+            uint64_t readCalls;
+            uint64_t holeBytes;
+            Poco::Timestamp::TimeDiff readTime;
+            Poco::Timestamp::TimeDiff countTime;
+            Poco::Timestamp::TimeDiff reduceTime;
+            uint64_t latencies[LATENCY_BUCKETS];
+        };
+
+        // Not copyable.
+        RunStatistics(const RunStatistics&);
+        RunStatistics &operator=(const RunStatistics&);
+
+        mutable Poco::FastMutex m_mutex;
+        Totals m_totals;
+    };
+}
+
+#endif
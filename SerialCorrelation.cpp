@@ -0,0 +1,115 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file SerialCorrelation.cpp
+* Contains the implementation of a class that measures how strongly each 
+* byte of a file depends on the one before it.
+*/
+
+// Module includes
+#include "SerialCorrelation.h"
+
+namespace EntropyModule
+{
+    SerialCorrelation::SerialCorrelation()
+    {
+        reset();
+    }
+
+    void SerialCorrelation::reset()
+    {
+        m_productSum = 0;
+        m_length = 0;
+        m_first = 0;
+        m_last = 0;
+    }
+
+    void SerialCorrelation::add(const uint8_t *data, size_t length)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+
+        if (m_length == 0)
+        {
+            m_first = data[0];
+        }
+        else
+        {
+            m_productSum += static_cast<uint32_t>(m_last) * data[0];
+        }
+
+        // A product is at most 16 bits, so a 64-bit sum cannot overflow for
+        // any file shorter than 2^48 bytes.
+        uint64_t sum = 0;
+        for (size_t i = 1; i < length; ++i)
+        {
+            sum += static_cast<uint32_t>(data[i - 1]) * data[i];
+        }
+
+        m_productSum += sum;
+        m_last = data[length - 1];
+        m_length += length;
+    }
+
+    bool SerialCorrelation::coefficient(const uint64_t *counts, uint64_t total, double &coefficient) const
+    {
+        if (m_length < 2 || total != m_length)
+        {
+            return false;
+        }
+
+        // Like the sum of products, these sums are exact in 64 bits for any 
+        // file shorter than 2^48 bytes, so each is rounded only once.
+        uint64_t byteSum = 0;
+        uint64_t byteSumOfSquares = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            uint64_t value = static_cast<uint64_t>(i);
+            byteSum += counts[i] * value;
+            byteSumOfSquares += counts[i] * value * value;
+        }
+
+        double n = static_cast<double>(total);
+        double sum = static_cast<double>(byteSum);
+        double sumOfSquares = static_cast<double>(byteSumOfSquares);
+        double productSum = static_cast<double>(m_productSum + static_cast<uint32_t>(m_last) * m_first);
+        double denominator = n * sumOfSquares - sum * sum;
+        if (denominator == 0.0)
+        {
+            return false;
+        }
+
+        coefficient = (n * productSum - sum * sum) / denominator;
+        return true;
+    }
+}
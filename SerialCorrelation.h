@@ -0,0 +1,86 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file SerialCorrelation.h
+* Contains the interface of a class that measures how strongly each byte of
+* a file depends on the one before it.
+*/
+
+#ifndef _ENTROPY_SERIALCORRELATION_H
+#define _ENTROPY_SERIALCORRELATION_H
+
+// Module includes
+#include "ContentAnalyzer.h"
+
+namespace EntropyModule
+{
+    /**
+    * Computes the serial correlation coefficient of a file's bytes, the 
+    * correlation between each byte and the next with the last byte paired
+    * with the first, as reported by ent. Random data scores close to 0; 
+    * text and images score well above it. 
+    *
+    * Only the sum of the products of adjacent bytes is accumulated while 
+    * the content is examined. The sums of the bytes and of their squares 
+    * are taken from the byte histogram at the end.
+    */
+    class SerialCorrelation : public ContentAnalyzer
+    {
+    public:
+        SerialCorrelation();
+
+        /**
+        * Prepares the coefficient for a new file.
+        */
+        void reset();
+
+        virtual void add(const uint8_t *data, size_t length);
+
+        /**
+        * Computes the coefficient.
+        *
+        * @param counts The file's 256 byte counts.
+        * @param total The sum of the counts.
+        * @param coefficient Receives the coefficient, between -1 and 1.
+        * @return False if the coefficient is undefined, which it is when all 
+        * the bytes have the same value.
+        */
+        bool coefficient(const uint64_t *counts, uint64_t total, double &coefficient) const;
+
+    private:
+        uint64_t m_productSum;
+        uint64_t m_length;
+        uint8_t m_first;
+        uint8_t m_last;
+    };
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ThreadContext.cpp
+* Contains the implementation of the classes that give each thread 
+* analyzing files its own buffers and counters.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ThreadContext.h"
+
+// C/C++ library includes
+#include <memory>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace EntropyModule
+{
+    ThreadContext::ThreadContext() :
+        m_pBlockProfile(NULL),
+        m_pPyramid(NULL),
+        m_pSerialCorrelation(NULL),
+        m_pMonteCarloPi(NULL)
+    {
+    }
+
+    const std::vector<ContentAnalyzer*> &ThreadContext::resetAnalyzers(const ModuleConfig &config)
+    {
+        m_analyzers.clear();
+        m_pBlockProfile = NULL;
+        m_pPyramid = NULL;
+        m_pSerialCorrelation = NULL;
+        m_pMonteCarloPi = NULL;
+
+        if (config.blockSize > 0)
+        {
+            if (m_blockProfile.get() == NULL)
+            {
+                m_blockProfile.reset(new BlockProfile(config.blockSize, config.blockStride, config.blockThreshold, config.blockSeries));
+            }
+            else
+            {
+                m_blockProfile->reset(config.blockSize, config.blockStride, config.blockThreshold, config.blockSeries);
+            }
+
+            m_pBlockProfile = m_blockProfile.get();
+            m_analyzers.push_back(m_pBlockProfile);
+        }
+
+        if (!config.pyramidDir.empty())
+        {
+            if (m_pyramid.get() == NULL)
+            {
+                m_pyramid.reset(new EntropyPyramid(config.pyramidBlockSize, config.pyramidLevels));
+            }
+            else
+            {
+                m_pyramid->reset(config.pyramidBlockSize, config.pyramidLevels);
+            }
+
+            m_pPyramid = m_pyramid.get();
+            m_analyzers.push_back(m_pPyramid);
+        }
+
+        if (config.serialCorrelation)
+        {
+            if (m_serialCorrelation.get() == NULL)
+            {
+                m_serialCorrelation.reset(new SerialCorrelation());
+            }
+            else
+            {
+                m_serialCorrelation->reset();
+            }
+
+            m_pSerialCorrelation = m_serialCorrelation.get();
+            m_analyzers.push_back(m_pSerialCorrelation);
+        }
+
+        if (config.monteCarloPi)
+        {
+            if (m_monteCarloPi.get() == NULL)
+            {
+                m_monteCarloPi.reset(new MonteCarloPi());
+            }
+            else
+            {
+                m_monteCarloPi->reset();
+            }
+
+            m_pMonteCarloPi = m_monteCarloPi.get();
+            m_analyzers.push_back(m_pMonteCarloPi);
+        }
+
+        return m_analyzers;
+    }
+
+    EntropySampler &ThreadContext::resetSampler(const ModuleConfig &config)
+    {
+        if (m_sampler.get() == NULL)
+        {
+            m_sampler.reset(new EntropySampler(config.sampleBlockSize, config.sampleEpsilon, config.sampleMinBlocks));
+        }
+        else
+        {
+            m_sampler->reset(config.sampleBlockSize, config.sampleEpsilon, config.sampleMinBlocks);
+        }
+
+        return *m_sampler;
+    }
+
+    ThreadContexts::ThreadContexts()
+    {
+        // Each registry has a key of its own, so a thread still holding a 
+        // context of a destroyed registry never finds it through a new one.
+#ifdef _WIN32
+        m_key = TlsAlloc();
+        if (m_key == TLS_OUT_OF_INDEXES)
+        {
+            throw TskException("failed to allocate thread-local storage");
+        }
+#else
+        if (pthread_key_create(&m_key, NULL) != 0)
+        {
+            throw TskException("failed to allocate thread-local storage");
+        }
+#endif
+    }
+
+    ThreadContexts::~ThreadContexts()
+    {
+#ifdef _WIN32
+        TlsFree(m_key);
+#else
+        pthread_key_delete(m_key);
+#endif
+        for (size_t i = 0; i < m_contexts.size(); ++i)
+        {
+            delete m_contexts[i];
+        }
+    }
+
+    ThreadContext &ThreadContexts::current()
+    {
+#ifdef _WIN32
+        ThreadContext *pContext = static_cast<ThreadContext*>(TlsGetValue(m_key));
+#else
+        ThreadContext *pContext = static_cast<ThreadContext*>(pthread_getspecific(m_key));
+#endif
+        if (pContext != NULL)
+        {
+            return *pContext;
+        }
+
+        std::auto_ptr<ThreadContext> context(new ThreadContext());
+        {
+            Poco::FastMutex::ScopedLock lock(m_mutex);
+            m_contexts.push_back(context.get());
+        }
+
+        // The registry owns the context from here on, even if it cannot be
+        // stored for the thread.
+        pContext = context.release();
+#ifdef _WIN32
+        bool stored = TlsSetValue(m_key, pContext) != FALSE;
+#else
+        bool stored = pthread_setspecific(m_key, pContext) == 0;
+#endif
+        if (!stored)
+        {
+            throw TskException("failed to store thread-local context");
+        }
+
+        return *pContext;
+    }
+
+    void ThreadContexts::addStatisticsTo(RunStatistics &total) const
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        for (size_t i = 0; i < m_contexts.size(); ++i)
+        {
+            total.add(m_contexts[i]->statistics());
+        }
+    }
+}
@@ -0,0 +1,188 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ThreadContext.h
+* Contains the interface of the classes that give each thread analyzing 
+* files its own buffers and counters.
+*/
+
+#ifndef _ENTROPY_THREADCONTEXT_H
+#define _ENTROPY_THREADCONTEXT_H
+
+// Module includes
+#include "AlignedBuffer.h"
+#include "BlockProfile.h"
+#include "ByteHistogram.h"
+#include "EntropyPyramid.h"
+#include "EntropySampler.h"
+#include "ModuleConfig.h"
+#include "MonteCarloPi.h"
+#include "ResultAttribute.h"
+#include "RunStatistics.h"
+#include "SerialCorrelation.h"
+
+// Poco includes
+#include "Poco/Mutex.h"
+
+// C/C++ library includes
+#include <memory>
+#include <vector>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace EntropyModule
+{
+    /**
+    * The state one thread reuses from file to file: the read buffer, the 
+    * byte histogram, a scratch histogram for counting chunks, the content
+    * analyzers, the sampler, the list of attributes to post and the 
+    * thread's share of the run statistics. Only the owning thread uses the
+    * buffer, the histograms, the analyzers, the sampler and the 
+    * attributes, so none of them is locked, and all keep their memory 
+    * between files.
+    */
+    class ThreadContext
+    {
+    public:
+        ThreadContext();
+
+        AlignedBuffer &buffer() { return m_buffer; }
+        ByteHistogram &histogram() { return m_histogram; }
+        ByteHistogram &scratch() { return m_scratch; }
+        ResultAttributes &attributes() { return m_attributes; }
+        RunStatistics &statistics() { return m_statistics; }
+        const RunStatistics &statistics() const { return m_statistics; }
+
+        /**
+        * Resets the analyzers the settings enable, other than the byte 
+        * histogram, for a new file. Each analyzer is created the first 
+        * time it is enabled and reused for every later file.
+        *
+        * @param config The module's settings.
+        * @return The enabled analyzers.
+        * @throws std::bad_alloc if an analyzer cannot be created.
+        */
+        const std::vector<ContentAnalyzer*> &resetAnalyzers(const ModuleConfig &config);
+
+        /**
+        * Resets the sampler for a file to be sampled with the settings. 
+        * The sampler is created the first time it is needed and reused for
+        * every later file.
+        *
+        * @param config The module's settings.
+        * @return The sampler.
+        * @throws std::bad_alloc if the sampler cannot be created.
+        */
+        EntropySampler &resetSampler(const ModuleConfig &config);
+
+        /**
+        * @return The analyzer, or NULL if the settings last given to 
+        * resetAnalyzers() do not enable it.
+        */
+        BlockProfile *blockProfile() const { return m_pBlockProfile; }
+        EntropyPyramid *pyramid() const { return m_pPyramid; }
+        SerialCorrelation *serialCorrelation() const { return m_pSerialCorrelation; }
+        MonteCarloPi *monteCarloPi() const { return m_pMonteCarloPi; }
+
+    private:
+        // Not copyable.
+        ThreadContext(const ThreadContext&);
+        ThreadContext &operator=(const ThreadContext&);
+
+        AlignedBuffer m_buffer;
+        ByteHistogram m_histogram;
+        ByteHistogram m_scratch;
+        ResultAttributes m_attributes;
+        RunStatistics m_statistics;
+
+        // The analyzers created so far, and those enabled for the current
+        // file.
+        std::auto_ptr<BlockProfile> m_blockProfile;
+        std::auto_ptr<EntropyPyramid> m_pyramid;
+        std::auto_ptr<SerialCorrelation> m_serialCorrelation;
+        std::auto_ptr<MonteCarloPi> m_monteCarloPi;
+        std::auto_ptr<EntropySampler> m_sampler;
+        std::vector<ContentAnalyzer*> m_analyzers;
+        BlockProfile *m_pBlockProfile;
+        EntropyPyramid *m_pPyramid;
+        SerialCorrelation *m_pSerialCorrelation;
+        MonteCarloPi *m_pMonteCarloPi;
+    };
+
+    /**
+    * Creates a context for each thread the first time the thread asks for 
+    * one, and owns the contexts until it is destroyed. A thread finds its
+    * context through thread-local storage without taking a lock; the lock
+    * is only taken to register a new context and to total the statistics.
+    *
+    * Contexts are not released when their thread exits, only when the 
+    * registry is destroyed, so the registry must outlive any use of the 
+    * contexts.
+    */
+    class ThreadContexts
+    {
+    public:
+        /**
+        * @throws TskException if no thread-local storage is available.
+        */
+        ThreadContexts();
+        ~ThreadContexts();
+
+        /**
+        * @return The calling thread's context.
+        * @throws std::bad_alloc if a new context cannot be allocated.
+        */
+        ThreadContext &current();
+
+        /**
+        * Adds the statistics of every thread to a total.
+        *
+        * @param total The total.
+        */
+        void addStatisticsTo(RunStatistics &total) const;
+
+    private:
+        // Not copyable.
+        ThreadContexts(const ThreadContexts&);
+        ThreadContexts &operator=(const ThreadContexts&);
+
+#ifdef _WIN32
+        unsigned long m_key;
+#else
+        pthread_key_t m_key;
+#endif
+        mutable Poco::FastMutex m_mutex;
+        std::vector<ThreadContext*> m_contexts;
+    };
+}
+
+#endif
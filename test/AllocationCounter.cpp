@@ -0,0 +1,112 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file AllocationCounter.cpp
+* Contains replacements of the global allocation operators that count the
+* heap allocations a program makes.
+*/
+
+// Module includes
+#include "AllocationCounter.h"
+
+// Poco includes
+#include "Poco/AtomicCounter.h"
+
+// C/C++ library includes
+#include <new>
+#include <stdlib.h>
+
+namespace
+{
+    Poco::AtomicCounter allocations;
+
+    void *allocate(size_t size)
+    {
+        ++allocations;
+        void *memory = malloc(size > 0 ? size : 1);
+        if (memory == NULL)
+        {
+            throw std::bad_alloc();
+        }
+
+        return memory;
+    }
+}
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+    return allocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t&) throw()
+{
+    ++allocations;
+    return malloc(size > 0 ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t&) throw()
+{
+    ++allocations;
+    return malloc(size > 0 ? size : 1);
+}
+
+void operator delete(void *memory) throw()
+{
+    free(memory);
+}
+
+void operator delete[](void *memory) throw()
+{
+    free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t&) throw()
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t&) throw()
+{
+    free(memory);
+}
+
+namespace EntropyTest
+{
+    unsigned int allocationCount()
+    {
+        return static_cast<unsigned int>(allocations.value());
+    }
+}
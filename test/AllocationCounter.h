@@ -0,0 +1,53 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file AllocationCounter.h
+* Contains the interface for counting the heap allocations a program makes.
+*/
+
+#ifndef _ENTROPY_ALLOCATIONCOUNTER_H
+#define _ENTROPY_ALLOCATIONCOUNTER_H
+
+namespace EntropyTest
+{
+    /**
+    * Returns the number of allocations made through operator new and 
+    * operator new[] since the program started. Linking AllocationCounter.cpp
+    * into a program replaces the global operators with counting ones; 
+    * they are safe to call from several threads. The count wraps around, 
+    * so only differences between two calls are meaningful.
+    *
+    * @return The number of allocations.
+    */
+    unsigned int allocationCount();
+}
+
+#endif
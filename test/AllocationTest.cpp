@@ -0,0 +1,164 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file AllocationTest.cpp
+* Contains a test that analyzing a file, once a thread has analyzed one 
+* with the same settings, makes no heap allocations of the module's own.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "AllocationCounter.h"
+#include "MockImgDB.h"
+#include "MockTskFile.h"
+
+// C/C++ library includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C" 
+{
+    TskModule::Status initialize(const char* arguments);
+    TskModule::Status run(TskFile *pFile);
+    TskModule::Status finalize();
+}
+
+namespace
+{
+    const size_t LARGEST_FILE_SIZE = 3 * 1024 * 1024;
+
+    /**
+    * @return The allocations the attributes of a file cost because of
+    * their contexts. A context too long for a string's own storage is 
+    * allocated when the module builds the attribute and when the attribute
+    * is added to the thread's list, then copied into a 
+    * TskBlackboardAttribute, which is copied again when it is passed to 
+    * the file.
+    */
+    unsigned int contextAllocations(const std::vector<TskBlackboardAttribute> &attributes)
+    {
+        unsigned int allocations = 0;
+        for (size_t i = 0; i < attributes.size(); ++i)
+        {
+            if (attributes[i].getContext().size() > std::string().capacity())
+            {
+                allocations += 4;
+            }
+        }
+
+        return allocations;
+    }
+
+    /**
+    * Analyzes files of several sizes with one set of arguments, each after
+    * a file as large as the largest, and checks the allocations made.
+    *
+    * @return The number of files that allocated more than expected.
+    */
+    int testArguments(const char *arguments, const std::vector<char> &content)
+    {
+        if (initialize(arguments) != TskModule::OK)
+        {
+            std::cerr << "AllocationTest: [" << arguments << "] initialize failed" << std::endl;
+            return 1;
+        }
+
+        const size_t sizes[] = { 0, 1, 100, 50000, 1024 * 1024 + 17, LARGEST_FILE_SIZE };
+        int failures = 0;
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        {
+            // Grow the thread's buffers and analyzers to their largest, 
+            // then find what the file's attribute contexts cost.
+            EntropyTest::MemoryTskFile warmUp(1, &content[0], LARGEST_FILE_SIZE);
+            run(&warmUp);
+
+            EntropyTest::MemoryTskFile file(2, &content[0], sizes[i]);
+            file.keepAttributes(true);
+            run(&file);
+            unsigned int expected = contextAllocations(file.posted());
+            file.keepAttributes(false);
+            file.reset();
+
+            unsigned int allocations = EntropyTest::allocationCount();
+            TskModule::Status status = run(&file);
+            allocations = EntropyTest::allocationCount() - allocations;
+            if (status != TskModule::OK || allocations > expected)
+            {
+                std::cerr << "AllocationTest: [" << arguments << "] size " << sizes[i] << ": " << allocations 
+                    << " allocations, expected at most " << expected << std::endl;
+                ++failures;
+            }
+        }
+
+        finalize();
+        return failures;
+    }
+}
+
+int main()
+{
+    EntropyTest::MockImgDB imgDB;
+    TskServices::Instance().setImgDB(imgDB);
+
+    std::vector<char> content(LARGEST_FILE_SIZE);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < content.size(); ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        content[i] = static_cast<char>(state);
+    }
+
+    // Settings that post byte arrays or write files allocate for them, so
+    // block_series, post_histogram and pyramid_dir are not tested, and 
+    // neither is read_ahead, which starts a reader thread for each file.
+    const char *const ARGUMENTS[] = 
+    {
+        "",
+        "buffer_size=64K",
+        "chi_square=true;mean=true;renyi_entropy=true;post_band=true",
+        "block_size=4096",
+        "block_size=64K;block_stride=4K;serial_correlation=true;monte_carlo_pi=true",
+        "sample_above=1M;sample_block_size=16K;sample_min_blocks=8"
+    };
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(ARGUMENTS) / sizeof(ARGUMENTS[0]); ++i)
+    {
+        failures += testArguments(ARGUMENTS[i], content);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file BatchTest.cpp
+* Contains a test of how runBatch() reports files when the attributes of a
+* batch cannot all be posted and committed.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "MockImgDB.h"
+#include "MockTskFile.h"
+
+// C/C++ library includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C" 
+{
+    TskModule::Status initialize(const char* arguments);
+    TskModule::Status runBatch(TskFile **files, size_t count, TskModule::Status *statuses);
+    TskModule::Status finalize();
+}
+
+namespace
+{
+    const size_t FILE_COUNT = 8;
+    const size_t FAILING_FILE = 3;
+
+    int failures = 0;
+
+    void check(bool condition, const std::string &test, const std::string &what)
+    {
+        if (!condition)
+        {
+            std::cerr << "BatchTest: " << test << ": " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    /**
+    * Runs a batch in which one file's attributes may fail to be posted.
+    */
+    void runCase(const std::string &test, EntropyTest::MockImgDB &imgDB, bool failPosting, bool transaction, bool commit)
+    {
+        std::vector<char> content(4096);
+        for (size_t i = 0; i < content.size(); ++i)
+        {
+            content[i] = static_cast<char>(i * 7);
+        }
+
+        std::vector<EntropyTest::MemoryTskFile*> files;
+        std::vector<TskFile*> batch;
+        for (size_t i = 0; i < FILE_COUNT; ++i)
+        {
+            files.push_back(new EntropyTest::MemoryTskFile(i + 1, &content[0], content.size()));
+            batch.push_back(files.back());
+        }
+
+        files[FAILING_FILE]->failPosting(failPosting);
+        imgDB.failBegin(!transaction);
+        imgDB.failCommit(!commit);
+        int commits = imgDB.commits();
+
+        std::vector<TskModule::Status> statuses(FILE_COUNT);
+        TskModule::Status status = runBatch(&batch[0], FILE_COUNT, &statuses[0]);
+
+        // Every file whose attributes were posted is processed once they 
+        // are committed, and the transaction is never left open.
+        check(status == (!failPosting && commit ? TskModule::OK : TskModule::FAIL), test, "batch status");
+        check(imgDB.commits() - commits == (transaction ? 1 : 0), test, "commits");
+        check(!imgDB.inTransaction(), test, "transaction left open");
+        for (size_t i = 0; i < FILE_COUNT; ++i)
+        {
+            bool posted = !failPosting || i != FAILING_FILE;
+            check((files[i]->postedCount() > 0) == posted, test, "attributes posted");
+            bool ok = posted && commit;
+            check(statuses[i] == (ok ? TskModule::OK : TskModule::FAIL), test, "file status");
+            delete files[i];
+        }
+    }
+}
+
+int main()
+{
+    EntropyTest::MockImgDB imgDB;
+    TskServices::Instance().setImgDB(imgDB);
+    if (initialize("") != TskModule::OK)
+    {
+        std::cerr << "BatchTest: initialize failed" << std::endl;
+        return 1;
+    }
+
+    runCase("posted", imgDB, false, true, true);
+    runCase("posting fails in a transaction", imgDB, true, true, true);
+    runCase("posting fails without a transaction", imgDB, true, false, true);
+    runCase("commit fails", imgDB, false, true, false);
+
+    finalize();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,546 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file EntropyBench.cpp
+* Contains a program that measures the module's throughput, per-file 
+* latency and allocations per file, outside a pipeline, on synthetic files
+* and on files from disk.
+*
+* Usage: EntropyBench [--args ARGUMENTS] [--passes N] [--batch N] 
+*                     [--corpus NAME]... [PATH]...
+*
+* ARGUMENTS is the module's argument string, as given to initialize(). 
+* Each corpus is analyzed once to warm up and then N times (default 3), 
+* with run() or, if --batch is given, with runBatch() on N files at a time.
+* The synthetic corpora are zero, random, text and small; all four are 
+* used when neither a corpus nor a path is given. Each PATH, a file or a 
+* directory that is searched recursively, is a corpus of files from disk,
+* which are given to the module as local copies.
+*
+* One line of JSON is written to the standard output for each corpus, with
+* the bytes and files analyzed per second, the median and 99th percentile
+* per-file latency in microseconds and the mean number of heap allocations
+* per file, so runs can be compared over time.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "AllocationCounter.h"
+#include "MockImgDB.h"
+#include "MockTskFile.h"
+
+// Poco includes
+#include "Poco/File.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Path.h"
+#include "Poco/Timestamp.h"
+
+// C/C++ library includes
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+extern "C" 
+{
+    TskModule::Status initialize(const char* arguments);
+    TskModule::Status run(TskFile *pFile);
+    TskModule::Status runBatch(TskFile **files, size_t count, TskModule::Status *statuses);
+    TskModule::Status finalize();
+}
+
+namespace
+{
+    const size_t LARGE_FILE_COUNT = 8;
+    const size_t LARGE_FILE_SIZE = 8 * 1024 * 1024;
+    const size_t SMALL_FILE_COUNT = 8192;
+    const size_t SMALL_FILE_MAX_SIZE = 8192;
+
+    /**
+    * A deterministic pseudo-random sequence, so every run sees the same 
+    * content.
+    */
+    class Random
+    {
+    public:
+        Random() : m_state(0x9E3779B97F4A7C15ULL) {}
+
+        uint64_t next()
+        {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 7;
+            m_state ^= m_state << 17;
+            return m_state;
+        }
+
+    private:
+        uint64_t m_state;
+    };
+
+    /**
+    * The files of a corpus. Synthetic files are slices of one block of 
+    * content in memory; files from disk are read when they are analyzed.
+    */
+    struct Corpus
+    {
+        std::string name;
+        std::vector<char> content;
+        std::vector<size_t> offsets;
+        std::vector<std::string> paths;
+        std::vector<uint64_t> sizes;
+    };
+
+    struct Options
+    {
+        Options() : passes(3), batch(0) {}
+
+        std::string arguments;
+        size_t passes;
+        size_t batch;
+        std::vector<std::string> corpora;
+        std::vector<std::string> paths;
+    };
+
+    void fillText(Random &random, char *data, size_t size)
+    {
+        static const char *const WORDS[] = 
+        {
+            "the", "of", "and", "to", "in", "is", "file", "entropy", "module", "framework", "data", "image",
+            "that", "for", "with", "as", "on", "be", "by", "this", "from", "at", "or", "an", "are", "which"
+        };
+        const size_t wordCount = sizeof(WORDS) / sizeof(WORDS[0]);
+
+        size_t position = 0;
+        while (position < size)
+        {
+            uint64_t value = random.next();
+            const char *word = WORDS[value % wordCount];
+            while (*word != '\0' && position < size)
+            {
+                data[position++] = *word++;
+            }
+
+            if (position < size)
+            {
+                data[position++] = (value >> 32) % 12 == 0 ? '\n' : ' ';
+            }
+        }
+    }
+
+    /**
+    * Builds a synthetic corpus.
+    *
+    * @return False if the name is not that of a synthetic corpus.
+    */
+    bool makeSyntheticCorpus(const std::string &name, Corpus &corpus)
+    {
+        Random random;
+        corpus.name = name;
+        if (name == "small")
+        {
+            // Mostly text, with every fourth file random, of sizes up to a
+            // couple of buffers.
+            size_t total = 0;
+            for (size_t i = 0; i < SMALL_FILE_COUNT; ++i)
+            {
+                corpus.offsets.push_back(total);
+                corpus.sizes.push_back(1 + random.next() % SMALL_FILE_MAX_SIZE);
+                total += static_cast<size_t>(corpus.sizes.back());
+            }
+
+            corpus.content.resize(total);
+            for (size_t i = 0; i < SMALL_FILE_COUNT; ++i)
+            {
+                char *data = &corpus.content[corpus.offsets[i]];
+                size_t size = static_cast<size_t>(corpus.sizes[i]);
+                if (i % 4 == 3)
+                {
+                    for (size_t j = 0; j < size; ++j)
+                    {
+                        data[j] = static_cast<char>(random.next());
+                    }
+                }
+                else
+                {
+                    fillText(random, data, size);
+                }
+            }
+
+            return true;
+        }
+
+        if (name != "zero" && name != "random" && name != "text")
+        {
+            return false;
+        }
+
+        corpus.content.resize(LARGE_FILE_COUNT * LARGE_FILE_SIZE);
+        for (size_t i = 0; i < LARGE_FILE_COUNT; ++i)
+        {
+            corpus.offsets.push_back(i * LARGE_FILE_SIZE);
+            corpus.sizes.push_back(LARGE_FILE_SIZE);
+        }
+
+        if (name == "random")
+        {
+            for (size_t i = 0; i < corpus.content.size(); i += sizeof(uint64_t))
+            {
+                uint64_t value = random.next();
+                std::copy(reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + sizeof(value), &corpus.content[i]);
+            }
+        }
+        else if (name == "text")
+        {
+            fillText(random, &corpus.content[0], corpus.content.size());
+        }
+
+        return true;
+    }
+
+    void addDiskFiles(const std::string &path, Corpus &corpus)
+    {
+        Poco::File file(path);
+        if (file.isDirectory())
+        {
+            std::vector<std::string> names;
+            file.list(names);
+            std::sort(names.begin(), names.end());
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                addDiskFiles(Poco::Path(Poco::Path::forDirectory(path), names[i]).toString(), corpus);
+            }
+        }
+        else if (file.isFile())
+        {
+            corpus.paths.push_back(path);
+            corpus.sizes.push_back(file.getSize());
+        }
+    }
+
+    /**
+    * Creates the mock of a file of a corpus.
+    */
+    EntropyTest::MockTskFile *makeFile(const Corpus &corpus, size_t index)
+    {
+        uint64_t id = index + 1;
+        if (corpus.paths.empty())
+        {
+            return new EntropyTest::MemoryTskFile(id, &corpus.content[corpus.offsets[index]], static_cast<size_t>(corpus.sizes[index]));
+        }
+
+        return new EntropyTest::DiskTskFile(id, corpus.paths[index], corpus.sizes[index]);
+    }
+
+    /**
+    * What was measured over the timed passes of a corpus.
+    */
+    struct Measurement
+    {
+        Measurement() : files(0), bytes(0), failures(0), allocations(0), elapsed(0) {}
+
+        uint64_t files;
+        uint64_t bytes;
+        uint64_t failures;
+        uint64_t allocations;
+        Poco::Timestamp::TimeDiff elapsed;
+        std::vector<Poco::Timestamp::TimeDiff> latencies;
+    };
+
+    /**
+    * Analyzes the files of a corpus once, one batch of files at a time. 
+    * Only the module's calls are timed and have their allocations counted,
+    * not the creation of the mocks.
+    */
+    void analyzeCorpus(const Corpus &corpus, size_t batchSize, Measurement *pMeasurement)
+    {
+        size_t perCall = batchSize > 0 ? batchSize : 1;
+        std::vector<EntropyTest::MockTskFile*> files;
+        std::vector<TskFile*> batch;
+        std::vector<TskModule::Status> statuses(perCall);
+        for (size_t first = 0; first < corpus.sizes.size(); first += perCall)
+        {
+            size_t count = std::min(perCall, corpus.sizes.size() - first);
+            for (size_t i = 0; i < count; ++i)
+            {
+                files.push_back(makeFile(corpus, first + i));
+                batch.push_back(files.back());
+            }
+
+            unsigned int allocations = EntropyTest::allocationCount();
+            Poco::Timestamp started;
+            if (batchSize > 0)
+            {
+                runBatch(&batch[0], count, &statuses[0]);
+            }
+            else
+            {
+                statuses[0] = run(batch[0]);
+            }
+
+            Poco::Timestamp::TimeDiff elapsed = started.elapsed();
+            allocations = EntropyTest::allocationCount() - allocations;
+
+            if (pMeasurement != NULL)
+            {
+                pMeasurement->files += count;
+                pMeasurement->allocations += allocations;
+                pMeasurement->elapsed += elapsed;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    pMeasurement->bytes += corpus.sizes[first + i];
+                    pMeasurement->failures += statuses[i] != TskModule::OK;
+                    pMeasurement->latencies.push_back(elapsed / static_cast<Poco::Timestamp::TimeDiff>(count));
+                }
+            }
+
+            for (size_t i = 0; i < files.size(); ++i)
+            {
+                delete files[i];
+            }
+
+            files.clear();
+            batch.clear();
+        }
+    }
+
+    /**
+    * @return The latency below which a fraction of the files fall, by the
+    * nearest-rank method. The latencies must be sorted.
+    */
+    Poco::Timestamp::TimeDiff percentile(const std::vector<Poco::Timestamp::TimeDiff> &latencies, double fraction)
+    {
+        if (latencies.empty())
+        {
+            return 0;
+        }
+
+        size_t rank = static_cast<size_t>(fraction * latencies.size() + 0.999999);
+        return latencies[std::min(latencies.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+    std::string jsonString(const std::string &value)
+    {
+        std::string quoted = "\"";
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            char c = value[i];
+            if (c == '"' || c == '\\')
+            {
+                quoted += '\\';
+                quoted += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                sprintf(escaped, "\\u%04x", c);
+                quoted += escaped;
+            }
+            else
+            {
+                quoted += c;
+            }
+        }
+
+        return quoted + "\"";
+    }
+
+    void printMeasurement(const Corpus &corpus, const Options &options, Measurement &measurement)
+    {
+        std::sort(measurement.latencies.begin(), measurement.latencies.end());
+        double seconds = measurement.elapsed / 1000000.0;
+        double files = static_cast<double>(measurement.files);
+
+        std::ostringstream line;
+        line << "{\"corpus\":" << jsonString(corpus.name)
+            << ",\"arguments\":" << jsonString(options.arguments)
+            << ",\"passes\":" << options.passes
+            << ",\"batch\":" << options.batch
+            << ",\"files\":" << measurement.files
+            << ",\"bytes\":" << measurement.bytes
+            << ",\"failures\":" << measurement.failures
+            << ",\"seconds\":" << seconds
+            << ",\"bytes_per_second\":" << (seconds > 0.0 ? measurement.bytes / seconds : 0.0)
+            << ",\"files_per_second\":" << (seconds > 0.0 ? files / seconds : 0.0)
+            << ",\"latency_p50_us\":" << percentile(measurement.latencies, 0.50)
+            << ",\"latency_p99_us\":" << percentile(measurement.latencies, 0.99)
+            << ",\"allocations_per_file\":" << (files > 0.0 ? measurement.allocations / files : 0.0)
+            << "}";
+        std::cout << line.str() << std::endl;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "usage: EntropyBench [--args ARGUMENTS] [--passes N] [--batch N] [--corpus zero|random|text|small]... [PATH]..." << std::endl;
+    }
+
+    bool parseCount(const char *text, size_t &count)
+    {
+        unsigned int value = 0;
+        if (!Poco::NumberParser::tryParseUnsigned(text, value))
+        {
+            return false;
+        }
+
+        count = value;
+        return true;
+    }
+
+    bool parseOptions(int argc, char *argv[], Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string option = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (option == "--args" && hasValue)
+            {
+                options.arguments = argv[++i];
+            }
+            else if (option == "--passes" && hasValue)
+            {
+                if (!parseCount(argv[++i], options.passes) || options.passes == 0)
+                {
+                    return false;
+                }
+            }
+            else if (option == "--batch" && hasValue)
+            {
+                if (!parseCount(argv[++i], options.batch))
+                {
+                    return false;
+                }
+            }
+            else if (option == "--corpus" && hasValue)
+            {
+                options.corpora.push_back(argv[++i]);
+            }
+            else if (option.compare(0, 2, "--") == 0)
+            {
+                return false;
+            }
+            else
+            {
+                options.paths.push_back(option);
+            }
+        }
+
+        if (options.corpora.empty() && options.paths.empty())
+        {
+            options.corpora.push_back("zero");
+            options.corpora.push_back("random");
+            options.corpora.push_back("text");
+            options.corpora.push_back("small");
+        }
+
+        return true;
+    }
+
+    /**
+    * Measures the module on a corpus and prints the measurement.
+    *
+    * @return False if the module could not be initialized.
+    */
+    bool benchCorpus(const Corpus &corpus, const Options &options)
+    {
+        if (initialize(options.arguments.c_str()) != TskModule::OK)
+        {
+            std::cerr << "EntropyBench: the module rejected the arguments '" << options.arguments << "'" << std::endl;
+            return false;
+        }
+
+        // The untimed pass sets up the module's per-thread state and 
+        // brings files from disk into the file cache.
+        analyzeCorpus(corpus, options.batch, NULL);
+
+        Measurement measurement;
+        measurement.latencies.reserve(options.passes * corpus.sizes.size());
+        for (size_t pass = 0; pass < options.passes; ++pass)
+        {
+            analyzeCorpus(corpus, options.batch, &measurement);
+        }
+
+        finalize();
+        printMeasurement(corpus, options, measurement);
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    EntropyTest::MockImgDB imgDB;
+    TskServices::Instance().setImgDB(imgDB);
+
+    try
+    {
+        for (size_t i = 0; i < options.corpora.size(); ++i)
+        {
+            Corpus corpus;
+            if (!makeSyntheticCorpus(options.corpora[i], corpus))
+            {
+                std::cerr << "EntropyBench: unknown corpus " << options.corpora[i] << std::endl;
+                return 2;
+            }
+
+            if (!benchCorpus(corpus, options))
+            {
+                return 1;
+            }
+        }
+
+        for (size_t i = 0; i < options.paths.size(); ++i)
+        {
+            Corpus corpus;
+            corpus.name = options.paths[i];
+            addDiskFiles(options.paths[i], corpus);
+            if (!benchCorpus(corpus, options))
+            {
+                return 1;
+            }
+        }
+    }
+    catch (TskException &ex)
+    {
+        std::cerr << "EntropyBench: " << ex.message() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
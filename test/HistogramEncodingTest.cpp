@@ -0,0 +1,120 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file HistogramEncodingTest.cpp
+* Contains a test that histograms survive encoding and decoding, and that
+* malformed encodings, including counts too large for 64 bits, are 
+* rejected.
+*/
+
+// Module includes
+#include "HistogramEncoding.h"
+
+// C/C++ library includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if (!condition)
+        {
+            std::cerr << "HistogramEncodingTest: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    /**
+    * Builds the encoding of a histogram whose first count is given as 
+    * varint bytes and whose other counts are 0.
+    */
+    std::vector<unsigned char> encodingWithFirstCount(const unsigned char *varint, size_t length)
+    {
+        std::vector<unsigned char> encoded(1, EntropyModule::HISTOGRAM_ENCODING_VERSION);
+        encoded.insert(encoded.end(), varint, varint + length);
+        encoded.insert(encoded.end(), 255, 0);
+        return encoded;
+    }
+
+    bool decodes(const std::vector<unsigned char> &encoded, uint64_t counts[256])
+    {
+        return EntropyModule::decodeHistogram(&encoded[0], encoded.size(), counts);
+    }
+}
+
+int main()
+{
+    // Counts of every size round-trip, up to the largest.
+    uint64_t counts[256];
+    for (int i = 0; i < 256; ++i)
+    {
+        counts[i] = i < 64 ? (1ULL << i) - (i % 3) : static_cast<uint64_t>(i) * 977;
+    }
+    counts[200] = 0;
+    counts[254] = 1ULL << 63;
+    counts[255] = ~0ULL;
+
+    std::vector<unsigned char> encoded;
+    EntropyModule::encodeHistogram(counts, encoded);
+    uint64_t decoded[256];
+    check(decodes(encoded, decoded), "valid encoding rejected");
+    bool same = true;
+    for (int i = 0; i < 256; ++i)
+    {
+        same = same && decoded[i] == counts[i];
+    }
+    check(same, "counts changed by a round trip");
+
+    // Truncated or extended encodings and later versions are rejected.
+    std::vector<unsigned char> truncated(encoded.begin(), encoded.end() - 1);
+    check(!decodes(truncated, decoded), "truncated encoding accepted");
+    std::vector<unsigned char> extended(encoded);
+    extended.push_back(0);
+    check(!decodes(extended, decoded), "encoding with trailing bytes accepted");
+    encoded[0] = EntropyModule::HISTOGRAM_ENCODING_VERSION + 1;
+    check(!decodes(encoded, decoded), "later version accepted");
+
+    // A tenth varint byte may only hold the top bit of a count.
+    const unsigned char LARGEST[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    check(decodes(encodingWithFirstCount(LARGEST, sizeof(LARGEST)), decoded) && decoded[0] == ~0ULL, "largest count rejected");
+    const unsigned char OVERFLOWING[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02 };
+    check(!decodes(encodingWithFirstCount(OVERFLOWING, sizeof(OVERFLOWING)), decoded), "count past 64 bits accepted");
+    const unsigned char HIGH_BITS[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7F };
+    check(!decodes(encodingWithFirstCount(HIGH_BITS, sizeof(HIGH_BITS)), decoded), "bits past 64 accepted");
+    const unsigned char ELEVEN_BYTES[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x81, 0x00 };
+    check(!decodes(encodingWithFirstCount(ELEVEN_BYTES, sizeof(ELEVEN_BYTES)), decoded), "eleven-byte varint accepted");
+
+    return failures == 0 ? 0 : 1;
+}
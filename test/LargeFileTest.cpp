@@ -0,0 +1,289 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file LargeFileTest.cpp
+* Contains tests that counts past 2^32 per byte value survive the byte 
+* histogram's bank flushes and the reductions of the histogram, and that 
+* a sparse 6 GiB local file is counted exactly.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ByteHistogram.h"
+#include "ByteStatistics.h"
+#include "EntropyMath.h"
+#include "HistogramEncoding.h"
+#include "MockImgDB.h"
+#include "MockTskFile.h"
+
+// C/C++ library includes
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" 
+{
+    TskModule::Status initialize(const char* arguments);
+    TskModule::Status run(TskFile *pFile);
+    TskModule::Status finalize();
+}
+
+namespace
+{
+    const uint64_t GIB = 1024ULL * 1024 * 1024;
+    const size_t BUFFER_SIZE = 1024 * 1024;
+
+    int failures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if (!condition)
+        {
+            std::cerr << "LargeFileTest: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    std::string describe(uint64_t actual, uint64_t expected)
+    {
+        std::ostringstream text;
+        text << actual << " rather than " << expected;
+        return text.str();
+    }
+
+    /**
+    * Adds length bytes to a histogram by repeating a buffer, ending with 
+    * a partial buffer.
+    */
+    void addRepeated(EntropyModule::ByteHistogram &histogram, const std::vector<uint8_t> &buffer, uint64_t length)
+    {
+        while (length > 0)
+        {
+            size_t size = static_cast<size_t>(std::min<uint64_t>(buffer.size(), length));
+            histogram.add(&buffer[0], size);
+            length -= size;
+        }
+    }
+
+    /**
+    * Counts more than 2^32 bytes of one value with add() into each of the
+    * four banks, so that their 32-bit counters would wrap if the banks 
+    * were not flushed in time, and merges histograms whose banks still 
+    * hold counts.
+    */
+    void testBankFlushes()
+    {
+        // Every byte lands in the same bin. The odd length leaves counts 
+        // pending in the banks when the totals are read.
+        std::vector<uint8_t> zeros(BUFFER_SIZE, 0);
+        const uint64_t length = 16 * GIB + 12345;
+        EntropyModule::ByteHistogram histogram;
+        addRepeated(histogram, zeros, length);
+        check(histogram.total() == length, "add() total " + describe(histogram.total(), length));
+        check(histogram.counts()[0] == length, "add() count of 0 " + describe(histogram.counts()[0], length));
+        check(histogram.counts()[1] == 0, "add() counted bytes it was not given");
+
+        // Merging takes the pending banks of both histograms into account.
+        std::vector<uint8_t> sevens(BUFFER_SIZE, 7);
+        EntropyModule::ByteHistogram other;
+        addRepeated(other, sevens, GIB + 3);
+        addRepeated(other, zeros, GIB + 1);
+        histogram.merge(other);
+        check(histogram.total() == 18 * GIB + 12349, "merge() total " + describe(histogram.total(), 18 * GIB + 12349));
+        check(histogram.counts()[0] == 17 * GIB + 12346, "merge() count of 0 " + describe(histogram.counts()[0], 17 * GIB + 12346));
+        check(histogram.counts()[7] == GIB + 3, "merge() count of 7 " + describe(histogram.counts()[7], GIB + 3));
+
+        // Runs are added straight to the totals, on top of pending counts.
+        histogram.add(&sevens[0], 5);
+        histogram.addRun(7, 3 * GIB);
+        histogram.addRun(200, 5 * GIB);
+        check(histogram.counts()[7] == 4 * GIB + 8, "addRun() count of 7 " + describe(histogram.counts()[7], 4 * GIB + 8));
+        check(histogram.counts()[200] == 5 * GIB, "addRun() count of 200 " + describe(histogram.counts()[200], 5 * GIB));
+        check(histogram.total() == 26 * GIB + 12354, "addRun() total " + describe(histogram.total(), 26 * GIB + 12354));
+    }
+
+    /**
+    * Reduces histograms with more than 2^32 counts per byte value.
+    */
+    void testReductions()
+    {
+        // A uniform histogram has exactly 8 bits of entropy whatever the 
+        // size of the counts.
+        uint64_t counts[256];
+        for (int i = 0; i < 256; ++i)
+        {
+            counts[i] = 1ULL << 33;
+        }
+        uint64_t total = 1ULL << 41;
+        double collision = 0.0;
+        double minimum = 0.0;
+        EntropyModule::renyiEntropies(counts, total, collision, minimum);
+        check(std::fabs(EntropyModule::shannonEntropy(counts, total) - 8.0) < 1e-12, "uniform entropy is not 8");
+        check(std::fabs(collision - 8.0) < 1e-12 && std::fabs(minimum - 8.0) < 1e-12, "uniform Renyi entropies are not 8");
+        check(EntropyModule::chiSquare(counts, total) == 0.0, "uniform chi-square is not 0");
+        check(EntropyModule::arithmeticMean(counts, total) == 127.5, "uniform mean is not 127.5");
+
+        // Two equal bins hold one bit, and their mean needs the exact sum.
+        for (int i = 0; i < 256; ++i)
+        {
+            counts[i] = 0;
+        }
+        counts[1] = 1ULL << 40;
+        counts[254] = 1ULL << 40;
+        total = 1ULL << 41;
+        check(std::fabs(EntropyModule::shannonEntropy(counts, total) - 1.0) < 1e-12, "two-bin entropy is not 1");
+        check(EntropyModule::arithmeticMean(counts, total) == 127.5, "two-bin mean is not 127.5");
+
+        // A skewed histogram, where the small terms must not be lost next 
+        // to the large one, against a long double reference.
+        total = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            counts[i] = i == 0 ? 6 * GIB : (1ULL << 32) + static_cast<uint64_t>(i) * 977;
+            total += counts[i];
+        }
+        long double reference = 0.0L;
+        long double weighted = 0.0L;
+        for (int i = 0; i < 256; ++i)
+        {
+            long double p = static_cast<long double>(counts[i]) / static_cast<long double>(total);
+            reference -= p * std::log(p) / std::log(2.0L);
+            weighted += static_cast<long double>(counts[i]) * i;
+        }
+        double entropy = EntropyModule::shannonEntropy(counts, total);
+        check(std::fabs(entropy - static_cast<double>(reference)) < 1e-12, "skewed entropy is off the reference");
+        double mean = EntropyModule::arithmeticMean(counts, total);
+        check(std::fabs(mean - static_cast<double>(weighted / total)) < 1e-12, "skewed mean is off the reference");
+    }
+
+    /**
+    * Writes a sparse file of the given size with 1 MiB of data at each of
+    * the given offsets and adds the bytes it holds to counts.
+    */
+    bool writeSparseFile(const std::string &path, uint64_t size, const std::vector<uint64_t> &offsets, uint64_t counts[256])
+    {
+        std::vector<char> data(BUFFER_SIZE);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<char>(1 + (i * 131) % 255);
+        }
+
+        std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+        for (size_t i = 0; i < offsets.size(); ++i)
+        {
+            file.seekp(static_cast<std::streamoff>(offsets[i]));
+            file.write(&data[0], data.size());
+            for (size_t j = 0; j < data.size(); ++j)
+            {
+                ++counts[static_cast<uint8_t>(data[j])];
+            }
+        }
+        file.seekp(static_cast<std::streamoff>(size - 1));
+        file.put(0);
+        counts[0] += size - offsets.size() * data.size();
+        return file.good();
+    }
+
+    /**
+    * Runs the module over a sparse 6 GiB local file with data past 4 GiB.
+    */
+    void testSparseFile(const std::string &dir)
+    {
+        const uint64_t size = 6 * GIB;
+        std::vector<uint64_t> offsets;
+        offsets.push_back(0);
+        offsets.push_back(3 * GIB + 12345);
+        offsets.push_back(5 * GIB);
+        offsets.push_back(size - 2 * BUFFER_SIZE);
+
+        std::string path = dir + "/LargeFileTest.sparse";
+        uint64_t expected[256] = { 0 };
+        if (!writeSparseFile(path, size, offsets, expected))
+        {
+            check(false, "could not write " + path);
+            remove(path.c_str());
+            return;
+        }
+
+        check(initialize("map_files=true;mean=true;post_histogram=true") == TskModule::OK, "initialize failed");
+        EntropyTest::DiskTskFile file(1, path, size);
+        file.keepAttributes(true);
+        check(run(&file) == TskModule::OK, "run failed");
+        finalize();
+        remove(path.c_str());
+
+        const TskBlackboardAttribute *pEntropy = file.find(TSK_ENTROPY, "");
+        const TskBlackboardAttribute *pMean = file.find(TSK_VALUE, "mean");
+        const TskBlackboardAttribute *pHistogram = file.find(TSK_VALUE, "byte_histogram");
+        check(file.find(TSK_FLAG, "partial") == NULL, "sparse file flagged as partial");
+        check(pEntropy != NULL && pEntropy->getValueDouble() == EntropyModule::shannonEntropy(expected, size), 
+            "sparse file entropy differs from its content's");
+        check(pMean != NULL && pMean->getValueDouble() == EntropyModule::arithmeticMean(expected, size), 
+            "sparse file mean differs from its content's");
+
+        uint64_t counts[256];
+        std::vector<unsigned char> encoded;
+        if (pHistogram != NULL)
+        {
+            encoded = pHistogram->getValueBytes();
+        }
+        if (encoded.empty() || !EntropyModule::decodeHistogram(&encoded[0], encoded.size(), counts))
+        {
+            check(false, "sparse file histogram missing or malformed");
+            return;
+        }
+        uint64_t total = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            check(counts[i] == expected[i], "sparse file count " + describe(counts[i], expected[i]));
+            total += counts[i];
+        }
+        check(total == size, "sparse file total " + describe(total, size));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    EntropyTest::MockImgDB imgDB;
+    TskServices::Instance().setImgDB(imgDB);
+
+    testBankFlushes();
+    testReductions();
+    testSparseFile(argc > 1 ? argv[1] : ".");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file LocalFileReaderTest.cpp
+* Contains a test that a local file read without the file cache is read in
+* full even when the reads are refused, as direct reads into a misaligned 
+* buffer are.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "LocalFileReader.h"
+
+// C/C++ library includes
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+    // The file is written next to the test, since the directory for 
+    // temporary files is often on a file system without direct I/O.
+    std::string path = std::string(argc > 1 ? argv[1] : ".") + "/LocalFileReaderTest.dat";
+    const size_t fileSize = 3 * 65536 + 123;
+    std::vector<char> content(fileSize);
+    for (size_t i = 0; i < content.size(); ++i)
+    {
+        content[i] = static_cast<char>(i * 31 + i / 4096);
+    }
+
+    {
+        std::ofstream stream(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        stream.write(&content[0], content.size());
+        if (!stream)
+        {
+            std::cerr << "LocalFileReaderTest: cannot write " << path << std::endl;
+            return 1;
+        }
+    }
+
+    int failures = 0;
+    try
+    {
+        EntropyModule::LocalFileReader reader;
+        if (!reader.open(path, EntropyModule::LocalFileReader::BYPASS_CACHE))
+        {
+            std::cerr << "LocalFileReaderTest: cannot open " << path << std::endl;
+            ++failures;
+        }
+        else
+        {
+            // One byte past an aligned start, and an odd length, which a 
+            // direct read refuses.
+            std::vector<char> buffer(65536 + 4096 + 1);
+            std::vector<char> read;
+            size_t length = 0;
+            while ((length = reader.read(&buffer[1], 65536 - 1)) > 0)
+            {
+                read.insert(read.end(), buffer.begin() + 1, buffer.begin() + 1 + length);
+            }
+
+            if (read != content)
+            {
+                std::cerr << "LocalFileReaderTest: read " << read.size() << " bytes, not the " << content.size() << " written" << std::endl;
+                ++failures;
+            }
+        }
+    }
+    catch (TskException &ex)
+    {
+        std::cerr << "LocalFileReaderTest: " << ex.message() << std::endl;
+        ++failures;
+    }
+
+    remove(path.c_str());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MockImgDB.cpp
+* Contains the implementation of a TskImgDB that lets the module run 
+* outside a pipeline, for the benchmark and the tests.
+*/
+
+// Module includes
+#include "MockImgDB.h"
+
+namespace EntropyTest
+{
+    MockImgDB::MockImgDB() :
+        m_begins(0),
+        m_commits(0),
+        m_inTransaction(false),
+        m_failBegin(false),
+        m_failCommit(false)
+    {
+    }
+
+    TskImgDB::KNOWN_STATUS MockImgDB::getKnownStatus(const uint64_t fileId) const
+    {
+        std::map<uint64_t, KNOWN_STATUS>::const_iterator it = m_knownStatus.find(fileId);
+        return it != m_knownStatus.end() ? it->second : IMGDB_FILES_UNKNOWN;
+    }
+
+    int MockImgDB::begin()
+    {
+        ++m_begins;
+        m_inTransaction = !m_failBegin;
+        return m_failBegin ? 1 : 0;
+    }
+
+    int MockImgDB::commit()
+    {
+        ++m_commits;
+        m_inTransaction = false;
+        return m_failCommit ? 1 : 0;
+    }
+}
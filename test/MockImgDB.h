@@ -0,0 +1,98 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MockImgDB.h
+* Contains the interface of a TskImgDB that lets the module run outside a 
+* pipeline, for the benchmark and the tests.
+*/
+
+#ifndef _ENTROPY_MOCKIMGDB_H
+#define _ENTROPY_MOCKIMGDB_H
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// C/C++ library includes
+#include <map>
+
+namespace EntropyTest
+{
+    /**
+    * An image database holding only what the module asks of it: the known
+    * status of files, and the transactions it posts batches in. Files are 
+    * unknown unless set otherwise.
+    */
+    class MockImgDB : public TskImgDB
+    {
+    public:
+        MockImgDB();
+
+        virtual KNOWN_STATUS getKnownStatus(const uint64_t fileId) const;
+        virtual int begin();
+        virtual int commit();
+
+        /**
+        * Sets the known status of a file.
+        */
+        void setKnownStatus(uint64_t fileId, KNOWN_STATUS status) { m_knownStatus[fileId] = status; }
+
+        /**
+        * Sets whether begin() and commit() fail, returning 1.
+        */
+        void failBegin(bool fail) { m_failBegin = fail; }
+        void failCommit(bool fail) { m_failCommit = fail; }
+
+        /**
+        * @return The number of calls to begin().
+        */
+        int begins() const { return m_begins; }
+
+        /**
+        * @return The number of calls to commit().
+        */
+        int commits() const { return m_commits; }
+
+        /**
+        * @return True if a transaction was begun and not committed since.
+        */
+        bool inTransaction() const { return m_inTransaction; }
+
+    private:
+        std::map<uint64_t, KNOWN_STATUS> m_knownStatus;
+        int m_begins;
+        int m_commits;
+        bool m_inTransaction;
+        bool m_failBegin;
+        bool m_failCommit;
+    };
+}
+
+#endif
@@ -0,0 +1,163 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MockTskFile.cpp
+* Contains the implementation of TskFile implementations that let the 
+* module run outside a pipeline, for the benchmark and the tests.
+*/
+
+// Module includes
+#include "MockTskFile.h"
+
+// C/C++ library includes
+#include <string.h>
+
+namespace EntropyTest
+{
+    MockTskFile::MockTskFile(uint64_t id, TSK_OFF_T size) :
+        m_id(id),
+        m_size(size),
+        m_position(0),
+        m_keepAttributes(false),
+        m_failPosting(false),
+        m_postedCount(0),
+        m_readCalls(0)
+    {
+    }
+
+    ssize_t MockTskFile::read(char *buf, const size_t count)
+    {
+        ++m_readCalls;
+        if (m_position >= m_size)
+        {
+            return 0;
+        }
+
+        uint64_t left = static_cast<uint64_t>(m_size - m_position);
+        size_t length = left < count ? static_cast<size_t>(left) : count;
+        size_t bytesRead = readAt(static_cast<uint64_t>(m_position), buf, length);
+        m_position += bytesRead;
+        return static_cast<ssize_t>(bytesRead);
+    }
+
+    TSK_OFF_T MockTskFile::seek(const TSK_OFF_T off, const int whence)
+    {
+        TSK_OFF_T position = off;
+        if (whence == SEEK_CUR)
+        {
+            position += m_position;
+        }
+        else if (whence == SEEK_END)
+        {
+            position += m_size;
+        }
+
+        if (position < 0)
+        {
+            throw TskException("seek before the start of the file");
+        }
+
+        m_position = position;
+        return m_position;
+    }
+
+    std::string MockTskFile::getHash(TskImgDB::HASH_TYPE hashType) const
+    {
+        return hashType == TskImgDB::MD5 ? m_md5 : std::string();
+    }
+
+    void MockTskFile::addGenInfoAttribute(TskBlackboardAttribute attr)
+    {
+        if (m_failPosting)
+        {
+            throw TskException("MockTskFile::addGenInfoAttribute : posting failed");
+        }
+
+        ++m_postedCount;
+        if (m_keepAttributes)
+        {
+            m_posted.push_back(attr);
+        }
+    }
+
+    void MockTskFile::reset()
+    {
+        m_position = 0;
+        m_postedCount = 0;
+        m_readCalls = 0;
+        m_posted.clear();
+    }
+
+    const TskBlackboardAttribute *MockTskFile::find(int type, const std::string &context) const
+    {
+        for (size_t i = 0; i < m_posted.size(); ++i)
+        {
+            if (m_posted[i].getAttributeTypeID() == type && m_posted[i].getContext() == context)
+            {
+                return &m_posted[i];
+            }
+        }
+
+        return NULL;
+    }
+
+    MemoryTskFile::MemoryTskFile(uint64_t id, const char *data, size_t size) :
+        MockTskFile(id, static_cast<TSK_OFF_T>(size)),
+        m_data(data)
+    {
+    }
+
+    size_t MemoryTskFile::readAt(uint64_t offset, char *buffer, size_t length)
+    {
+        memcpy(buffer, m_data + offset, length);
+        return length;
+    }
+
+    DiskTskFile::DiskTskFile(uint64_t id, const std::string &path, uint64_t size) :
+        MockTskFile(id, static_cast<TSK_OFF_T>(size)),
+        m_stream(path.c_str(), std::ios::in | std::ios::binary)
+    {
+        if (!m_stream)
+        {
+            throw TskException("cannot open " + path);
+        }
+
+        setPath(path);
+    }
+
+    size_t DiskTskFile::readAt(uint64_t offset, char *buffer, size_t length)
+    {
+        m_stream.clear();
+        m_stream.seekg(static_cast<std::streamoff>(offset));
+        m_stream.read(buffer, static_cast<std::streamsize>(length));
+        return static_cast<size_t>(m_stream.gcount());
+    }
+}
@@ -0,0 +1,203 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file MockTskFile.h
+* Contains the interface of TskFile implementations that let the module run
+* outside a pipeline, for the benchmark and the tests.
+*/
+
+#ifndef _ENTROPY_MOCKTSKFILE_H
+#define _ENTROPY_MOCKTSKFILE_H
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// C/C++ library includes
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace EntropyTest
+{
+    /**
+    * A file whose content comes from a subclass rather than from an image.
+    * The attributes the module posts for it are counted, and kept if asked
+    * for. Keeping them allocates, so a file used to count allocations 
+    * should not keep them.
+    */
+    class MockTskFile : public TskFile
+    {
+    public:
+        /**
+        * @param id The file's id.
+        * @param size The size of the file's content in bytes.
+        */
+        MockTskFile(uint64_t id, TSK_OFF_T size);
+        virtual ~MockTskFile() {}
+
+        virtual ssize_t read(char *buf, const size_t count);
+        virtual TSK_OFF_T seek(const TSK_OFF_T off, const int whence = SEEK_SET);
+        virtual TSK_OFF_T tell() const { return m_position; }
+        virtual TSK_OFF_T getSize() const { return m_size; }
+        virtual void open() {}
+        virtual void close() {}
+        virtual bool exists() const { return !m_path.empty(); }
+        virtual std::string getPath() const { return m_path; }
+        virtual std::string getFullPath() const { return m_fullPath; }
+        virtual uint64_t getId() const { return m_id; }
+        virtual std::string getHash(TskImgDB::HASH_TYPE hashType) const;
+        virtual void addGenInfoAttribute(TskBlackboardAttribute attr);
+
+        /**
+        * Records the MD5 hash an earlier module would have put on the 
+        * blackboard, so the result cache can find the file.
+        */
+        void setMd5(const std::string &md5) { m_md5 = md5; }
+
+        /**
+        * Gives the file a local copy on disk, as the framework does for 
+        * files it has saved, so the module can map or read the copy.
+        */
+        void setPath(const std::string &path) { m_path = path; }
+
+        /**
+        * Sets the file's path in the image, which the resume store keys 
+        * files by.
+        */
+        void setFullPath(const std::string &fullPath) { m_fullPath = fullPath; }
+
+        /**
+        * Sets whether the posted attributes are kept. They are not by 
+        * default.
+        */
+        void keepAttributes(bool keep) { m_keepAttributes = keep; }
+
+        /**
+        * Sets whether posting an attribute throws a TskException, as when 
+        * the image database cannot store it.
+        */
+        void failPosting(bool fail) { m_failPosting = fail; }
+
+        /**
+        * Forgets the posted attributes and rewinds the file, so it can be 
+        * analyzed again.
+        */
+        void reset();
+
+        /**
+        * @return The number of attributes posted since the last reset().
+        */
+        size_t postedCount() const { return m_postedCount; }
+
+        /**
+        * @return The attributes posted since the last reset(), if they are
+        * kept.
+        */
+        const std::vector<TskBlackboardAttribute> &posted() const { return m_posted; }
+
+        /**
+        * Finds a kept attribute by its type and context.
+        *
+        * @return The attribute, or NULL if none was posted.
+        */
+        const TskBlackboardAttribute *find(int type, const std::string &context) const;
+
+        /**
+        * @return The number of read() calls made since the last reset().
+        */
+        size_t readCalls() const { return m_readCalls; }
+
+    protected:
+        /**
+        * Copies part of the file's content.
+        *
+        * @param offset The offset of the first byte, less than the size.
+        * @param buffer The buffer to copy into.
+        * @param length The number of bytes to copy, not past the end of the
+        * file.
+        * @return The number of bytes copied.
+        */
+        virtual size_t readAt(uint64_t offset, char *buffer, size_t length) = 0;
+
+    private:
+        uint64_t m_id;
+        TSK_OFF_T m_size;
+        TSK_OFF_T m_position;
+        std::string m_md5;
+        std::string m_path;
+        std::string m_fullPath;
+        bool m_keepAttributes;
+        bool m_failPosting;
+        size_t m_postedCount;
+        size_t m_readCalls;
+        std::vector<TskBlackboardAttribute> m_posted;
+    };
+
+    /**
+    * A file whose content is held in memory by the caller, which must keep
+    * it for the life of the file.
+    */
+    class MemoryTskFile : public MockTskFile
+    {
+    public:
+        MemoryTskFile(uint64_t id, const char *data, size_t size);
+
+    protected:
+        virtual size_t readAt(uint64_t offset, char *buffer, size_t length);
+
+    private:
+        const char *m_data;
+    };
+
+    /**
+    * A file whose content is read from a file on disk. The disk file is 
+    * also given as the file's local copy.
+    */
+    class DiskTskFile : public MockTskFile
+    {
+    public:
+        /**
+        * @param id The file's id.
+        * @param path The path of the disk file.
+        * @param size The size of the disk file.
+        * @throws TskException if the disk file cannot be opened.
+        */
+        DiskTskFile(uint64_t id, const std::string &path, uint64_t size);
+
+    protected:
+        virtual size_t readAt(uint64_t offset, char *buffer, size_t length);
+
+    private:
+        std::ifstream m_stream;
+    };
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file PyramidCacheTest.cpp
+* Contains a test that entropy pyramids are named after the content they 
+* describe, so the result cache replays the path of the right pyramid 
+* across runs and images, that a file whose cached pyramid is gone is
+* analyzed again, and that threads saving the same pyramid at once do not
+* interfere.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "EntropyPyramid.h"
+#include "MockImgDB.h"
+#include "MockTskFile.h"
+
+// Poco includes
+#include "Poco/File.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+
+// C/C++ library includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C" 
+{
+    TskModule::Status initialize(const char* arguments);
+    TskModule::Status run(TskFile *pFile);
+    TskModule::Status finalize();
+}
+
+namespace
+{
+    const char FIRST_MD5[] = "0123456789abcdef0123456789abcdef";
+    const char SECOND_MD5[] = "fedcba9876543210fedcba9876543210";
+
+    int failures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if (!condition)
+        {
+            std::cerr << "PyramidCacheTest: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    /**
+    * Analyzes a file and returns the path of its pyramid, or an empty 
+    * string if none was posted.
+    */
+    std::string analyze(uint64_t id, const std::string &md5, const std::vector<char> &content, size_t &readCalls)
+    {
+        EntropyTest::MemoryTskFile file(id, &content[0], content.size());
+        file.setMd5(md5);
+        file.keepAttributes(true);
+        check(run(&file) == TskModule::OK, "run failed");
+        readCalls = file.readCalls();
+        const TskBlackboardAttribute *pPath = file.find(TSK_PATH, "entropy_pyramid");
+        return pPath != NULL ? pPath->getValueString() : std::string();
+    }
+
+    /**
+    * Saves a pyramid to a path over and over, as pipeline threads do for 
+    * files with the same content.
+    */
+    class PyramidSaver : public Poco::Runnable
+    {
+    public:
+        PyramidSaver(const EntropyModule::EntropyPyramid &pyramid, const std::string &path) 
+            : m_pyramid(pyramid), m_path(path), m_failures(0)
+        {
+        }
+
+        virtual void run()
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                try
+                {
+                    m_pyramid.save(m_path);
+                }
+                catch (...)
+                {
+                    ++m_failures;
+                }
+            }
+        }
+
+        int failures() const { return m_failures; }
+
+    private:
+        const EntropyModule::EntropyPyramid &m_pyramid;
+        std::string m_path;
+        int m_failures;
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    EntropyTest::MockImgDB imgDB;
+    TskServices::Instance().setImgDB(imgDB);
+
+    std::string dir = std::string(argc > 1 ? argv[1] : ".") + "/PyramidCacheTest.out";
+    std::string arguments = "pyramid_dir=" + dir + ";cache_entries=16;cache_file=" + dir + "/results.cache";
+    remove((dir + "/results.cache").c_str());
+
+    std::vector<char> first(100000);
+    std::vector<char> second(100000);
+    for (size_t i = 0; i < first.size(); ++i)
+    {
+        first[i] = static_cast<char>(i * 7 + i / 1000);
+        second[i] = static_cast<char>(i % 13);
+    }
+
+    // The first run analyzes file 1 and caches its results.
+    size_t readCalls = 0;
+    check(initialize(arguments.c_str()) == TskModule::OK, "initialize failed");
+    std::string firstPath = analyze(1, FIRST_MD5, first, readCalls);
+    check(firstPath.find(FIRST_MD5) != std::string::npos && firstPath.find("-4096x4.entpyr") != std::string::npos, 
+        "pyramid not named after its content: " + firstPath);
+    check(Poco::File(firstPath).exists(), "pyramid not saved: " + firstPath);
+    finalize();
+
+    // A later run over another image has another file 1. Its pyramid must
+    // not overwrite the first, and a copy of the first file's content 
+    // shares the first pyramid without being read.
+    check(initialize(arguments.c_str()) == TskModule::OK, "initialize failed");
+    std::string secondPath = analyze(1, SECOND_MD5, second, readCalls);
+    check(secondPath != firstPath && !secondPath.empty(), "file 1 of another image shares the pyramid of file 1");
+    check(readCalls > 0, "file with new content was not read");
+    std::string copyPath = analyze(2, FIRST_MD5, first, readCalls);
+    check(copyPath == firstPath, "copy was given another pyramid: " + copyPath);
+    check(readCalls == 0, "copy was read rather than taken from the cache");
+
+    // Once the pyramid is gone, the cached path is not posted again.
+    Poco::File(firstPath).remove();
+    std::string regeneratedPath = analyze(3, FIRST_MD5, first, readCalls);
+    check(regeneratedPath == firstPath && Poco::File(firstPath).exists(), "deleted pyramid was not regenerated");
+    check(readCalls > 0, "file whose pyramid was deleted was not read");
+    finalize();
+
+    // Threads saving the same pyramid at once each write a file of their 
+    // own, so none of them fails and the pyramid is complete.
+    EntropyModule::EntropyPyramid pyramid(4096, 4);
+    pyramid.add(reinterpret_cast<const uint8_t*>(&first[0]), first.size());
+    pyramid.finish();
+    std::string sharedPath = dir + "/shared.entpyr";
+    PyramidSaver firstSaver(pyramid, sharedPath);
+    PyramidSaver secondSaver(pyramid, sharedPath);
+    Poco::Thread firstThread;
+    Poco::Thread secondThread;
+    firstThread.start(firstSaver);
+    secondThread.start(secondSaver);
+    firstThread.join();
+    secondThread.join();
+    check(firstSaver.failures() == 0 && secondSaver.failures() == 0, "concurrent saves of the same pyramid failed");
+    pyramid.save(dir + "/single.entpyr");
+    check(Poco::File(sharedPath).getSize() == Poco::File(dir + "/single.entpyr").getSize(), "concurrent saves left a damaged pyramid");
+
+    std::vector<std::string> names;
+    Poco::File(dir).list(names);
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        check(names[i].find(".tmp") == std::string::npos, "temporary pyramid left behind: " + names[i]);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file ResumeTest.cpp
+* Contains a test that counts are only resumed for a file whose counted 
+* content is unchanged, and that a damaged resume store is discarded 
+* rather than keeping the module from starting or resuming wrong counts.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ByteHistogram.h"
+#include "EntropyMath.h"
+#include "MockImgDB.h"
+#include "MockTskFile.h"
+
+// C/C++ library includes
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <math.h>
+#include <string>
+#include <vector>
+
+extern "C" 
+{
+    TskModule::Status initialize(const char* arguments);
+    TskModule::Status run(TskFile *pFile);
+    TskModule::Status finalize();
+}
+
+namespace
+{
+    const size_t FIRST_SIZE = 1024 * 1024;
+    const size_t GROWN_SIZE = FIRST_SIZE + 300000;
+
+    // The offset in a store holding the point of one file keyed "/a" of 
+    // the count of its first bin: the header, the key, the offset, the 
+    // fingerprint, the modification time, the bin count and the bin's value.
+    const std::streamoff FIRST_COUNT_OFFSET = 8 + 4 + 4 + 3 + 8 + 8 + 8 + 2 + 1;
+
+    int failures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if (!condition)
+        {
+            std::cerr << "ResumeTest: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    /**
+    * Analyzes the first size bytes of the content as the file "/a" and 
+    * checks that the entropy posted is that of those bytes.
+    */
+    void analyze(const std::string &test, const std::vector<char> &content, size_t size)
+    {
+        EntropyTest::MemoryTskFile file(1, &content[0], size);
+        file.setFullPath("/a");
+        file.keepAttributes(true);
+        check(run(&file) == TskModule::OK, test + ": run failed");
+
+        EntropyModule::ByteHistogram histogram;
+        histogram.add(reinterpret_cast<const uint8_t*>(&content[0]), size);
+        double expected = EntropyModule::shannonEntropy(histogram.counts(), histogram.total());
+        const TskBlackboardAttribute *pEntropy = file.find(TSK_ENTROPY, "");
+        check(pEntropy != NULL && fabs(pEntropy->getValueDouble() - expected) < 1e-12, test + ": wrong entropy");
+    }
+
+    /**
+    * Overwrites a byte of a file.
+    */
+    void patchByte(const std::string &path, std::streamoff offset, char value)
+    {
+        std::fstream stream(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekp(offset);
+        stream.put(value);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    EntropyTest::MockImgDB imgDB;
+    TskServices::Instance().setImgDB(imgDB);
+
+    std::string storePath = std::string(argc > 1 ? argv[1] : ".") + "/ResumeTest.store";
+    std::string arguments = "resume_entries=16;resume_file=" + storePath;
+    remove(storePath.c_str());
+
+    std::vector<char> content(GROWN_SIZE);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < content.size(); ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        content[i] = static_cast<char>(state % 61);
+    }
+
+    // Appending to a file resumes its counts; changing counted content in 
+    // place, anywhere, does not.
+    check(initialize(arguments.c_str()) == TskModule::OK, "initialize failed");
+    analyze("first", content, FIRST_SIZE);
+    analyze("appended", content, GROWN_SIZE);
+    content[FIRST_SIZE / 2 + 12345] = 100;
+    analyze("changed in place", content, GROWN_SIZE);
+    finalize();
+
+    // A point whose counts do not add up to its offset is not resumed from.
+    patchByte(storePath, FIRST_COUNT_OFFSET + 4, 1);
+    check(initialize(arguments.c_str()) == TskModule::OK, "initialize failed with a damaged point");
+    analyze("damaged point", content, GROWN_SIZE);
+    finalize();
+
+    // A truncated store does not keep the module from starting.
+    std::vector<char> store;
+    {
+        std::ifstream stream(storePath.c_str(), std::ios::in | std::ios::binary);
+        store.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream stream(storePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        stream.write(&store[0], store.size() / 2);
+    }
+    check(initialize(arguments.c_str()) == TskModule::OK, "initialize failed with a truncated store");
+    analyze("truncated store", content, GROWN_SIZE);
+    finalize();
+
+    remove(storePath.c_str());
+    return failures == 0 ? 0 : 1;
+}
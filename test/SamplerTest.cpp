@@ -0,0 +1,164 @@
+/*
+*
+*  The Sleuth Kit
+*
+*  Contact: Brian Carrier [carrier <at> sleuthkit [dot] org]
+*
+*  This is free and unencumbered software released into the public domain.
+*  
+*  Anyone is free to copy, modify, publish, use, compile, sell, or
+*  distribute this software, either in source code form or as a compiled
+*  binary, for any purpose, commercial or non-commercial, and by any
+*  means.
+*  
+*  In jurisdictions that recognize copyright laws, the author or authors
+*  of this software dedicate any and all copyright interest in the
+*  software to the public domain. We make this dedication for the benefit
+*  of the public at large and to the detriment of our heirs and
+*  successors. We intend this dedication to be an overt act of
+*  relinquishment in perpetuity of all present and future rights to this
+*  software under copyright law.
+*  
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+*  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+*  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+*  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+*  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+*  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+*  OTHER DEALINGS IN THE SOFTWARE. 
+*/
+
+/**
+* \file SamplerTest.cpp
+* Contains a test that the confidence interval posted for a sampled file 
+* describes the entropy posted with it.
+*/
+
+// TSK Framework includes
+#include "TskModuleDev.h"
+
+// Module includes
+#include "ByteHistogram.h"
+#include "EntropyMath.h"
+#include "MockImgDB.h"
+#include "MockTskFile.h"
+
+// C/C++ library includes
+#include <iostream>
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" 
+{
+    TskModule::Status initialize(const char* arguments);
+    TskModule::Status run(TskFile *pFile);
+    TskModule::Status finalize();
+}
+
+namespace
+{
+    const size_t BLOCK_SIZE = 64 * 1024;
+    const size_t BLOCK_COUNT = 1024;
+    const uint64_t MIN_BLOCKS = 32;
+
+    int failures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if (!condition)
+        {
+            std::cerr << "SamplerTest: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    double entropyOf(const std::vector<char> &content)
+    {
+        EntropyModule::ByteHistogram histogram;
+        histogram.add(reinterpret_cast<const uint8_t*>(&content[0]), content.size());
+        return EntropyModule::shannonEntropy(histogram.counts(), histogram.total());
+    }
+
+    /**
+    * Samples a file and checks that its entropy lies within the posted
+    * interval around the posted estimate.
+    *
+    * @return The fraction of the file that was sampled.
+    */
+    double sample(const std::string &name, const std::vector<char> &content)
+    {
+        EntropyTest::MemoryTskFile file(1, &content[0], content.size());
+        file.keepAttributes(true);
+        check(run(&file) == TskModule::OK, name + ": run failed");
+
+        const TskBlackboardAttribute *pEntropy = file.find(TSK_ENTROPY, "");
+        if (pEntropy == NULL)
+        {
+            check(false, name + ": no entropy posted");
+            return 0.0;
+        }
+
+        double coverage = 1.0;
+        double error = fabs(pEntropy->getValueDouble() - entropyOf(content));
+        if (file.find(TSK_FLAG, "sampled") != NULL)
+        {
+            const TskBlackboardAttribute *pCoverage = file.find(TSK_VALUE, "sample_coverage");
+            const TskBlackboardAttribute *pWidth = file.find(TSK_VALUE, "sample_interval_width");
+            check(pCoverage != NULL && pWidth != NULL, name + ": sampled without coverage or interval");
+            if (pCoverage != NULL && pWidth != NULL)
+            {
+                coverage = pCoverage->getValueDouble();
+                std::ostringstream text;
+                text << name << ": entropy off by " << error << " bits, outside an interval " << pWidth->getValueDouble() << " bits wide";
+                check(error <= pWidth->getValueDouble() / 2.0, text.str());
+            }
+        }
+        else
+        {
+            check(error < 1e-9, name + ": entropy of a fully read file is not exact");
+        }
+
+        return coverage;
+    }
+}
+
+int main()
+{
+    EntropyTest::MockImgDB imgDB;
+    TskServices::Instance().setImgDB(imgDB);
+
+    std::ostringstream arguments;
+    arguments << "sample_above=1M;sample_block_size=" << BLOCK_SIZE << ";sample_min_blocks=" << MIN_BLOCKS << ";sample_epsilon=0.01";
+    check(initialize(arguments.str().c_str()) == TskModule::OK, "initialize failed");
+
+    // Random content varies too little from block to block to need more
+    // than the minimum number of blocks.
+    std::vector<char> content(BLOCK_SIZE * BLOCK_COUNT);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < content.size(); ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        content[i] = static_cast<char>(state);
+    }
+
+    double coverage = sample("random", content);
+    check(coverage == static_cast<double>(MIN_BLOCKS) / BLOCK_COUNT, "random content was sampled beyond the minimum");
+
+    // Each block holds one value, a different value from its neighbours. 
+    // Every block has an entropy of 0 while the file's is 8 bits, so the 
+    // first blocks read cannot settle the estimate.
+    for (size_t i = 0; i < content.size(); ++i)
+    {
+        content[i] = static_cast<char>(i / BLOCK_SIZE);
+    }
+
+    coverage = sample("one value per block", content);
+    check(coverage > static_cast<double>(MIN_BLOCKS) / BLOCK_COUNT, "blocks of one value each stopped at the minimum");
+
+    finalize();
+    return failures == 0 ? 0 : 1;
+}